@@ -0,0 +1,17 @@
+QT       += core
+
+QT       -= gui
+
+TARGET = BenchmarkCompare
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+HEADERS += \
+    benchmarkresults.hh
+
+SOURCES += \
+    main.cc \
+    benchmarkresults.cc
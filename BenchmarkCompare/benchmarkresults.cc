@@ -0,0 +1,211 @@
+/**
+ * @file
+ * @brief Implements functions defined in benchmarkresults.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "benchmarkresults.hh"
+#include <QFile>
+#include <QTextStream>
+#include <QXmlStreamReader>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QHash>
+
+namespace
+{
+
+const QString CSV_HEADER("test_case,function,tag,metric,value,iterations");
+
+
+// Quote CSV field if it contains separators or quotes.
+QString csvField(const QString& field)
+{
+    if (!field.contains(',') && !field.contains('"')) return field;
+    QString quoted = field;
+    quoted.replace('"', "\"\"");
+    return '"' + quoted + '"';
+}
+
+} // Anonymous namespace
+
+
+QString BenchmarkResult::key() const
+{
+    return testCase + "::" + function + "(" + tag + ")/" + metric;
+}
+
+
+bool readQTestXml(const QString& fileName, std::vector<BenchmarkResult>* results, QString* error)
+{
+    Q_ASSERT(results != nullptr);
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)){
+        *error = file.errorString();
+        return false;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString testCase;
+    QString function;
+    while (!xml.atEnd()){
+        if (xml.readNext() != QXmlStreamReader::StartElement) continue;
+
+        QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestCase")){
+            testCase = attributes.value("name").toString();
+        }
+        else if (xml.name() == QLatin1String("TestFunction")){
+            function = attributes.value("name").toString();
+        }
+        else if (xml.name() == QLatin1String("BenchmarkResult")){
+            BenchmarkResult r;
+            bool valueOk, iterationsOk;
+            r.testCase = testCase;
+            r.function = function;
+            r.tag = attributes.value("tag").toString();
+            r.metric = attributes.value("metric").toString();
+            r.value = attributes.value("value").toDouble(&valueOk);
+            r.iterations = attributes.value("iterations").toInt(&iterationsOk);
+            if (!valueOk || !iterationsOk){
+                *error = fileName + ":" + QString::number(xml.lineNumber()) + ": invalid benchmark result.";
+                return false;
+            }
+            results->push_back(r);
+        }
+    }
+
+    if (xml.hasError()){
+        *error = fileName + ":" + QString::number(xml.lineNumber()) + ": " + xml.errorString();
+        return false;
+    }
+    return true;
+}
+
+
+bool readJson(const QString& fileName, std::vector<BenchmarkResult>* results, QString* error)
+{
+    Q_ASSERT(results != nullptr);
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)){
+        *error = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError){
+        *error = fileName + ": " + parseError.errorString();
+        return false;
+    }
+    if (!doc.isArray()){
+        *error = fileName + ": expected an array of results.";
+        return false;
+    }
+
+    for (const QJsonValue& value : doc.array()){
+        QJsonObject o = value.toObject();
+        if (!o.value("value").isDouble() || o.value("metric").toString().isEmpty()){
+            *error = fileName + ": invalid benchmark result.";
+            return false;
+        }
+        BenchmarkResult r;
+        r.testCase = o.value("testCase").toString();
+        r.function = o.value("function").toString();
+        r.tag = o.value("tag").toString();
+        r.metric = o.value("metric").toString();
+        r.value = o.value("value").toDouble();
+        r.iterations = o.value("iterations").toInt();
+        results->push_back(r);
+    }
+    return true;
+}
+
+
+bool writeJson(const std::vector<BenchmarkResult>& results, const QString& fileName, QString* error)
+{
+    QJsonArray array;
+    for (const BenchmarkResult& r : results){
+        QJsonObject o;
+        o.insert("testCase", r.testCase);
+        o.insert("function", r.function);
+        o.insert("tag", r.tag);
+        o.insert("metric", r.metric);
+        o.insert("value", r.value);
+        o.insert("iterations", r.iterations);
+        array.append(o);
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        *error = file.errorString();
+        return false;
+    }
+    QByteArray data = QJsonDocument(array).toJson();
+    if (file.write(data) != data.size()){
+        *error = "Could not write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+
+bool writeCsv(const std::vector<BenchmarkResult>& results, const QString& fileName, QString* error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)){
+        *error = file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << CSV_HEADER << '\n';
+    for (const BenchmarkResult& r : results){
+        out << csvField(r.testCase) << ',' << csvField(r.function) << ','
+            << csvField(r.tag) << ',' << csvField(r.metric) << ','
+            << QString::number(r.value, 'g', 12) << ',' << r.iterations << '\n';
+    }
+
+    out.flush();
+    if (out.status() != QTextStream::Ok){
+        *error = "Could not write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+
+bool isHigherBetter(const QString& metric)
+{
+    return metric == QLatin1String("FramesPerSecond") || metric == QLatin1String("BitsPerSecond") ||
+            metric == QLatin1String("BytesPerSecond");
+}
+
+
+std::vector<BenchmarkComparison> compare(const std::vector<BenchmarkResult>& results,
+                                         const std::vector<BenchmarkResult>& baseline,
+                                         double threshold)
+{
+    Q_ASSERT(threshold >= 0);
+    QHash<QString, double> base;
+    for (const BenchmarkResult& r : baseline){
+        base.insert(r.key(), r.value);
+    }
+
+    std::vector<BenchmarkComparison> comparisons;
+    comparisons.reserve(results.size());
+    for (const BenchmarkResult& r : results){
+        BenchmarkComparison c;
+        c.current = r;
+        c.baseline = base.value(r.key(), -1);
+        c.change = 0;
+        c.regression = false;
+        if (c.baseline > 0){
+            c.change = (r.value - c.baseline) / c.baseline;
+            c.regression = isHigherBetter(r.metric) ? c.change < -threshold : c.change > threshold;
+        }
+        comparisons.push_back(c);
+    }
+    return comparisons;
+}
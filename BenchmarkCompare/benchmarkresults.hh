@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @brief Defines the benchmark result record and the functions reading QTest
+ *  benchmark output, reading and writing result files and comparing runs.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef BENCHMARKRESULTS_HH
+#define BENCHMARKRESULTS_HH
+
+#include <QString>
+#include <vector>
+
+/**
+ * @brief Result of a single benchmark data row.
+ */
+struct BenchmarkResult
+{
+    QString testCase;   // Test executable, e.g. DatabaseHandlerBenchmark.
+    QString function;   // Test function, e.g. addEventBenchmark.
+    QString tag;        // Data row tag, empty for functions without test data.
+    QString metric;     // QTest metric, e.g. WalltimeMilliseconds.
+    double value;       // Measured value per iteration.
+    int iterations;
+
+    /**
+     * @brief Key identifying the same measurement in different runs.
+     */
+    QString key() const;
+};
+
+
+/**
+ * @brief Comparison of a result against the baseline.
+ */
+struct BenchmarkComparison
+{
+    BenchmarkResult current;
+    double baseline;        // Baseline value, or negative if measurement is new.
+    double change;          // Relative change ((current - baseline) / baseline).
+    bool regression;        // True, if change is worse than the threshold.
+};
+
+
+/**
+ * @brief Read benchmark results from QTest XML output (test run with '-o file,xml').
+ * @param fileName Path of the XML file.
+ * @param results Read results are appended here.
+ * @param error Error message is stored here if reading fails.
+ * @return True, if file was read.
+ */
+bool readQTestXml(const QString& fileName, std::vector<BenchmarkResult>* results, QString* error);
+
+/**
+ * @brief Read results written by writeJson.
+ * @param fileName Path of the JSON file.
+ * @param results Read results are appended here.
+ * @param error Error message is stored here if reading fails.
+ * @return True, if file was read.
+ */
+bool readJson(const QString& fileName, std::vector<BenchmarkResult>* results, QString* error);
+
+/**
+ * @brief Write results into a JSON file. JSON files can be used as baselines.
+ * @param results Written results.
+ * @param fileName Path of the file.
+ * @param error Error message is stored here if writing fails.
+ * @return True, if results were written.
+ */
+bool writeJson(const std::vector<BenchmarkResult>& results, const QString& fileName, QString* error);
+
+/**
+ * @brief Write results into a CSV file, one line per data row.
+ * @param results Written results.
+ * @param fileName Path of the file.
+ * @param error Error message is stored here if writing fails.
+ * @return True, if results were written.
+ */
+bool writeCsv(const std::vector<BenchmarkResult>& results, const QString& fileName, QString* error);
+
+/**
+ * @brief Check the direction of a metric.
+ * @param metric QTest metric name.
+ * @return True for rate metrics (FramesPerSecond, BitsPerSecond, BytesPerSecond),
+ *  false for metrics where lower values are better (times, counts).
+ */
+bool isHigherBetter(const QString& metric);
+
+/**
+ * @brief Compare results against the baseline. A result is a regression if it is
+ *  more than @p threshold worse than its baseline: higher for time and count metrics,
+ *  lower for rate metrics (see isHigherBetter).
+ * @param results Current results.
+ * @param baseline Baseline results.
+ * @param threshold Allowed relative change for the worse, e.g. 0.1 for 10 %.
+ * @return Comparison for each current result, in the order of @p results.
+ * @pre threshold >= 0.
+ */
+std::vector<BenchmarkComparison> compare(const std::vector<BenchmarkResult>& results,
+                                         const std::vector<BenchmarkResult>& baseline,
+                                         double threshold);
+
+#endif // BENCHMARKRESULTS_HH
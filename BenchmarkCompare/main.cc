@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Converts QTest benchmark output into JSON or CSV and compares
+ *  results against a stored baseline. Benchmarks write their results with
+ *  QTest's XML logger, e.g. 'DatabaseHandlerBenchmark -o results.xml,xml'
+ *  (ctest does this automatically for the benchmark suites).
+ *
+ *  Examples:
+ *    BenchmarkCompare DatabaseHandlerBenchmark.xml --json baseline.json
+ *    BenchmarkCompare DatabaseHandlerBenchmark.xml EventTimerLogicBenchmark.xml --csv results.csv
+ *    BenchmarkCompare DatabaseHandlerBenchmark.xml --baseline baseline.json --threshold 15
+ *
+ *  Exit status is 2 if any result regressed more than the threshold.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "benchmarkresults.hh"
+
+namespace
+{
+
+const int REGRESSION_EXIT_CODE = 2;
+
+
+// Print comparison table. Returns number of regressions.
+unsigned printComparison(const std::vector<BenchmarkComparison>& comparisons, double threshold)
+{
+    QTextStream out(stdout);
+    unsigned regressions = 0;
+    for (const BenchmarkComparison& c : comparisons){
+        out << (c.regression ? "REGRESSION " : "           ") << c.current.key() << ": "
+            << c.current.value;
+        if (c.baseline < 0){
+            out << " (no baseline)\n";
+            continue;
+        }
+        out << " vs " << c.baseline;
+        if (c.baseline > 0){
+            out << " (" << (c.change >= 0 ? "+" : "") << QString::number(c.change * 100, 'f', 1) << " %)";
+        }
+        out << '\n';
+        if (c.regression) ++regressions;
+    }
+    out << comparisons.size() << " results, " << regressions
+        << " regressions beyond " << threshold * 100 << " %.\n";
+    return regressions;
+}
+
+} // Anonymous namespace
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("BenchmarkCompare");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Convert QTest benchmark results and compare them against a baseline.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("results", "QTest XML output files ('-o file,xml') or JSON files written by --json.");
+    parser.addOptions({
+        {"json", "Write results to JSON <file>. The file can be used as a baseline.", "file"},
+        {"csv", "Write results to CSV <file>.", "file"},
+        {"baseline", "Compare results against baseline JSON <file>.", "file"},
+        {"threshold", "Allowed change for the worse against baseline in percent (default 10).", "percent"}
+    });
+    parser.process(app);
+
+    QTextStream err(stderr);
+    QStringList files = parser.positionalArguments();
+    if (files.isEmpty()){
+        parser.showHelp(1);
+    }
+
+    std::vector<BenchmarkResult> results;
+    QString error;
+    for (const QString& file : files){
+        bool ok = file.endsWith(".json", Qt::CaseInsensitive) ?
+                    readJson(file, &results, &error) : readQTestXml(file, &results, &error);
+        if (!ok){
+            err << error << '\n';
+            return 1;
+        }
+    }
+
+    if (parser.isSet("json") && !writeJson(results, parser.value("json"), &error)){
+        err << error << '\n';
+        return 1;
+    }
+    if (parser.isSet("csv") && !writeCsv(results, parser.value("csv"), &error)){
+        err << error << '\n';
+        return 1;
+    }
+    if (!parser.isSet("baseline")){
+        return 0;
+    }
+
+    bool ok = true;
+    double threshold = parser.isSet("threshold") ? parser.value("threshold").toDouble(&ok) : 10.0;
+    if (!ok || threshold < 0){
+        err << "Invalid threshold.\n";
+        return 1;
+    }
+
+    std::vector<BenchmarkResult> baseline;
+    if (!readJson(parser.value("baseline"), &baseline, &error)){
+        err << error << '\n';
+        return 1;
+    }
+
+    unsigned regressions = printComparison(compare(results, baseline, threshold / 100), threshold / 100);
+    return regressions == 0 ? 0 : REGRESSION_EXIT_CODE;
+}
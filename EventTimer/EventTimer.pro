@@ -17,13 +17,44 @@ HEADERS += \
     inc/eventhandler.hh \
     inc/logger.hh \
     inc/eventtimerbuilder.hh \
+    inc/latencyhistogram.hh \
+    inc/asynclogger.hh \
+    inc/databaseprofile.hh \
+    inc/tracerecorder.hh \
+    inc/scheduleview.hh \
     src/eventtimerlogic.hh \
     src/databasehandler.hh \
+    src/counter.hh \
+    src/scheduleindex.hh \
+    src/eventcache.hh \
+    src/namepool.hh \
+    src/timestamp.hh \
+    src/eventbatch.hh \
+    src/tracespan.hh \
+    src/snapshot.hh \
+    src/sharedschedule.hh \
+    src/schedulepublisher.hh \
+    src/eventtimercore.hh \
+    src/enginepolicies.hh \
     doxygeninfo.hh
 
 SOURCES += \
     src/event.cc \
+    src/timestamp.cc \
     src/eventtimerbuilder.cc \
     src/eventtimerlogic.cc \
-    src/databasehandler.cc
+    src/databasehandler.cc \
+    src/latencyhistogram.cc \
+    src/asynclogger.cc \
+    src/scheduleindex.cc \
+    src/eventcache.cc \
+    src/namepool.cc \
+    src/eventbatch.cc \
+    src/databaseprofile.cc \
+    src/tracerecorder.cc \
+    src/snapshot.cc \
+    src/schedulepublisher.cc \
+    src/scheduleview.cc
 
+# Expose tracing spans as USDT probes when systemtap headers are available.
+unix:exists(/usr/include/sys/sdt.h): DEFINES += EVENTTIMER_HAVE_SDT
@@ -0,0 +1,119 @@
+/**
+ * @file
+ * @brief Defines the AsyncLogger class, a Logger decorator that passes
+ *  log messages to another Logger in a background thread.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef ASYNCLOGGER_HH
+#define ASYNCLOGGER_HH
+
+#include "logger.hh"
+#include <QMutex>
+#include <QWaitCondition>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+class QThread;
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief Logger that queues messages into a fixed-size ring buffer and passes
+ *  them to the target logger in a background thread. Logging never blocks
+ *  on the target logger: if the buffer is full, message is dropped and counted.
+ *  Use AsyncLogger when the target logger is slow (e.g. writes to a file or network),
+ *  so that logging does not delay firing events.
+ */
+class AsyncLogger : public Logger
+{
+public:
+
+    /**
+     * @brief Constructor. Starts the background thread.
+     * @param target Logger that receives the messages. AsyncLogger does not take ownership.
+     * @param capacity Maximum number of queued messages.
+     * @param minLevel Messages below this level are discarded before formatting.
+     * @pre target != nullptr, capacity > 0. Target logger outlives AsyncLogger.
+     *  Target's isEnabled method must be re-entrant.
+     */
+    AsyncLogger(Logger* target, unsigned capacity = 1024, Level minLevel = LEVEL_DEBUG);
+
+    /**
+     * @brief Destructor. Passes remaining queued messages to the target and stops the background thread.
+     */
+    virtual ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * @brief Queue message with level LEVEL_INFO.
+     * @param msg Logged message.
+     * @pre -
+     */
+    virtual void logMsg(const QString& msg);
+
+    /**
+     * @brief Check if messages of given level are logged.
+     * @param level Message level.
+     * @return True, if @p level >= minLevel and target logger accepts the level.
+     * @pre -
+     */
+    virtual bool isEnabled(Level level) const;
+
+    /**
+     * @brief Queue message.
+     * @param level Message level.
+     * @param msg Logged message.
+     * @pre -
+     * @post Message is queued, or dropped if the queue is full.
+     */
+    virtual void log(Level level, const QString& msg);
+
+    /**
+     * @brief Wait until all queued messages have been passed to the target logger.
+     * @pre Not called from the target logger.
+     */
+    void flush();
+
+    /**
+     * @brief Get number of messages dropped because the queue was full.
+     * @return Number of dropped messages.
+     * @pre -
+     */
+    quint64 droppedMessages() const;
+
+
+private:
+
+    struct Entry
+    {
+        Level level;
+        QString msg;
+    };
+
+    class Worker;
+
+    Logger* target_;
+    Level minLevel_;
+    std::vector<Entry> ring_;
+    unsigned head_;
+    unsigned size_;
+    unsigned inProgress_;
+    bool stopping_;
+    std::atomic<quint64> dropped_;
+    QMutex mutex_;
+    QWaitCondition notEmpty_;
+    QWaitCondition drained_;
+    std::unique_ptr<QThread> worker_;
+
+    // Background thread main loop.
+    void run();
+};
+
+} // namespace EventTimerNS
+
+#endif // ASYNCLOGGER_HH
@@ -0,0 +1,80 @@
+/**
+ * @file
+ * @brief Defines the DatabaseProfile struct, SQLite performance settings
+ *  applied when the database is opened.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef DATABASEPROFILE_HH
+#define DATABASEPROFILE_HH
+
+#include <QString>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief SQLite performance settings. Settings are applied as PRAGMA statements
+ *  when the database is opened. Default constructed profile keeps the SQLite
+ *  defaults (rollback journal, synchronous=FULL). Other database drivers ignore the profile.
+ *  Use the presets to choose between durability and write throughput:
+ *  - durable(): WAL journal, every commit is synced to disk.
+ *  - balanced(): WAL journal, synced at checkpoints. A power loss may lose the
+ *    latest commits, but never corrupts the database.
+ *  - fast(): Journal in memory and no syncing. A crash may corrupt the database.
+ */
+struct DatabaseProfile
+{
+    /**
+     * @brief Constructor.
+     * @post All settings have SQLite default values.
+     */
+    DatabaseProfile();
+
+    /**
+     * @brief Journal mode (e.g. "WAL", "DELETE", "MEMORY"). Empty string keeps the default.
+     */
+    QString journalMode;
+
+    /**
+     * @brief Synchronous level ("OFF", "NORMAL", "FULL" or "EXTRA"). Empty string keeps the default.
+     */
+    QString synchronous;
+
+    /**
+     * @brief Maximum number of bytes of the database file to memory map. -1 keeps the default.
+     */
+    qint64 mmapSize;
+
+    /**
+     * @brief Page cache size in kibibytes. 0 keeps the default.
+     */
+    unsigned cacheSizeKib;
+
+    /**
+     * @brief How long a statement waits for a locked database (in milliseconds). -1 keeps the default.
+     */
+    int busyTimeoutMsec;
+
+    /**
+     * @brief Durable preset: WAL journal, synchronous=FULL.
+     * @return Profile.
+     */
+    static DatabaseProfile durable();
+
+    /**
+     * @brief Balanced preset: WAL journal, synchronous=NORMAL, 64 MiB memory map, 8 MiB cache.
+     * @return Profile.
+     */
+    static DatabaseProfile balanced();
+
+    /**
+     * @brief Throughput preset: journal in memory, synchronous=OFF, 256 MiB memory map, 32 MiB cache.
+     * @return Profile.
+     */
+    static DatabaseProfile fast();
+};
+
+} // namespace EventTimerNS
+
+#endif // DATABASEPROFILE_HH
@@ -10,6 +10,10 @@
 #include "event.hh"
 #include "eventhandler.hh"
 #include "logger.hh"
+#include "tracerecorder.hh"
+#include "latencyhistogram.hh"
+
+class QIODevice;
 
 namespace EventTimerNS
 {
@@ -36,6 +40,91 @@ public:
         CLEAR, NOTIFY
     };
 
+    /**
+     * @brief Snapshot of EventTimer's runtime counters.
+     *  All counters are cumulative since the EventTimer was created.
+     */
+    struct Statistics
+    {
+        /**
+         * @brief Number of SQL INSERT statements issued.
+         */
+        quint64 insertStatements;
+
+        /**
+         * @brief Number of SQL DELETE statements issued.
+         */
+        quint64 deleteStatements;
+
+        /**
+         * @brief Number of SQL UPDATE statements issued.
+         */
+        quint64 updateStatements;
+
+        /**
+         * @brief Number of SQL SELECT statements issued.
+         */
+        quint64 selectStatements;
+
+        /**
+         * @brief Number of result rows read by queries returning multiple events.
+         */
+        quint64 rowsScanned;
+
+        /**
+         * @brief Time spent in database operations (in nanoseconds).
+         */
+        quint64 databaseTimeNsec;
+
+        /**
+         * @brief Time spent in EventHandler::notify (in nanoseconds).
+         */
+        quint64 handlerTimeNsec;
+
+        /**
+         * @brief Number of events fired by the running timer
+         *  (NOTIFY cleanup policy notifications are not included).
+         */
+        quint64 eventsFired;
+
+        /**
+         * @brief Number of occured events rescheduled to their next repeat.
+         */
+        quint64 eventsRescheduled;
+
+        /**
+         * @brief Number of events removed (cancelled, or occured with no repeats left).
+         */
+        quint64 eventsRemoved;
+
+        /**
+         * @brief Number of currently scheduled events. Read from the timer's in-memory
+         *  schedule. Counted in the database (one SELECT statement) only if the schedule
+         *  could not be loaded or stats() is called from another thread.
+         */
+        quint64 queueDepth;
+
+        /**
+         * @brief Number of getEvent calls served from the event cache.
+         */
+        quint64 cacheHits;
+
+        /**
+         * @brief Number of getEvent calls that queried the database.
+         */
+        quint64 cacheMisses;
+
+        /**
+         * @brief Number of checks for occured events made by the running timer.
+         */
+        quint64 checks;
+
+        /**
+         * @brief Time spent in checks, including database operations and notifications (in nanoseconds).
+         */
+        quint64 checkTimeNsec;
+    };
+
     /**
      * @brief Mandatory virtual destructor.
      */
@@ -64,13 +153,42 @@ public:
      */
     virtual bool removeEvent(unsigned eventId) = 0;
 
+    /**
+     * @brief Cancel multiple scheduled events at once. This is considerably faster
+     *  than calling removeEvent for each event separately.
+     * @param eventIds Ids of events to be cancelled. Unknown ids are ignored.
+     * @return True, if events were cancelled successfully.
+     * @pre -
+     * @post Removes all events or returns false and does not modify schedules.
+     *  In case of failure, error message is available calling errorString(). If logger is set, it will be notified.
+     */
+    virtual bool removeEvents(const std::vector<unsigned>& eventIds) = 0;
+
+    /**
+     * @brief Change occurence time, interval and repeats of a scheduled event.
+     *  Event keeps its id, name and type. This is considerably faster than
+     *  removing the event and adding a new one.
+     * @param eventId Id of the rescheduled event.
+     * @param timestamp New occurence time.
+     * @param interval New repeat interval in milliseconds.
+     * @param repeats New number of repeats (Event::INFINITE_REPEAT for infinite repeat).
+     * @return True, if event was rescheduled successfully.
+     * @pre @p timestamp is in valid format (Event::TIME_FORMAT) and represents a valid datetime.
+     *  @p repeats == 0 || @p interval != 0 (as in Event::isValid). Otherwise returns false.
+     * @post Event is rescheduled or returns false and does not modify schedules.
+     *  In case of failure (e.g. no such event), error message is available calling errorString().
+     *  If logger is set, it will be notified.
+     */
+    virtual bool rescheduleEvent(unsigned eventId, const QString& timestamp,
+                                 unsigned interval, unsigned repeats) = 0;
+
     /**
      * @brief Get event matching to the id.
      * @param eventId Event id.
      * @return Corresponding event with its current values
      *  (may have been updated since adding the event).
      *  If getting event fails, returns event with unassigned id.
-     * @pre -
+     * @pre -. May be called from any thread, if EventTimer was configured with reader connections.
      * @post If getting event fails, more info is available calling errorString().
      *  If logger is set, it will be notified in case of failure.
      */
@@ -81,7 +199,7 @@ public:
      * @param amount Number of events included in the list.
      * @return Vector of next occuring events. Vector has up to 'amount' elements.
      *  All events are valid and represent existing, scheduled events.
-     * @pre amount != 0.
+     * @pre amount != 0. May be called from any thread, if EventTimer was configured with reader connections.
      * @post If operation fails, error string is available calling errorString().
      *  If logger is set, it will be notified in case of error.
      *  Note: This method does not check for expired events. Therefore this method
@@ -89,6 +207,24 @@ public:
      */
     virtual std::vector<Event> nextEvents(unsigned amount) = 0;
 
+    /**
+     * @brief Get one page of events occuring within a time range, ordered by
+     *  timestamp (events with the same timestamp are ordered by id).
+     *  To get the next page, pass the last event of the previous page as @p after.
+     *  Each page costs the same regardless of how deep in the range it is.
+     * @param from Start of the range (inclusive).
+     * @param to End of the range (exclusive).
+     * @param limit Maximum number of events on the page.
+     * @param after Last event of the previous page. Default constructed event for the first page.
+     * @return Vector of up to @p limit events.
+     * @pre @p from and @p to are in valid format (Event::TIME_FORMAT) and represent valid datetimes.
+     *  limit != 0. May be called from any thread, if EventTimer was configured with reader connections.
+     * @post If operation fails, returns empty vector and error string is available calling errorString().
+     *  If logger is set, it will be notified in case of error.
+     */
+    virtual std::vector<Event> eventsBetween(const QString& from, const QString& to,
+                                             unsigned limit, const Event& after = Event()) = 0;
+
     /**
      * @brief Remove all dynamic events from schedule.
      * @return True, if all dynamic events were removed.
@@ -109,6 +245,31 @@ public:
      */
     virtual bool clearAll() = 0;
 
+    /**
+     * @brief Write the whole schedule into a compact, versioned binary snapshot.
+     *  Snapshot does not depend on the database backend, so it can be used to
+     *  move a schedule between databases.
+     * @param device Output device, e.g. a QFile. EventTimer does not take ownership over it.
+     * @return True, if snapshot was written.
+     * @pre EventTimer is in a valid state. device != nullptr and is open for writing.
+     * @post In case of error, error message is available calling errorString().
+     *  If logger is set, it will be notified.
+     */
+    virtual bool exportSnapshot(QIODevice* device) = 0;
+
+    /**
+     * @brief Add all events of a snapshot written by exportSnapshot in a single transaction.
+     *  This is considerably faster than adding the events one by one. Events keep
+     *  their ids, and their timestamps are converted to local time of this machine.
+     * @param device Input device. EventTimer does not take ownership over it.
+     * @return True, if all events were added. Fails, if snapshot is corrupted or
+     *  any of its ids is already in use.
+     * @pre EventTimer is in a valid state. device != nullptr and is open for reading.
+     * @post Adds all events or does not modify schedule. In case of error,
+     *  error message is available calling errorString(). If logger is set, it will be notified.
+     */
+    virtual bool importSnapshot(QIODevice* device) = 0;
+
     /**
      * @brief Assign handler for occured events.
      * @param handler EventHandler provided by component user.
@@ -128,9 +289,19 @@ public:
      */
     virtual void setLogger(Logger* logger) = 0;
 
+    /**
+     * @brief Set recorder for tracing timer checks, database calls, rescheduling
+     *  of expired events and event handler notifications.
+     * @param recorder Trace recorder provided by component user, or nullptr to
+     *  disable tracing (default). EventTimer does not take ownership over the recorder.
+     * @pre Other threads are not reading events through the EventTimer.
+     * @post Spans of EventTimer's operations are recorded into the recorder.
+     */
+    virtual void setTraceRecorder(TraceRecorder* recorder) = 0;
+
     /**
      * @brief Get error message.
-     * @return Error message describing the latest occured error.
+     * @return Error message describing the latest error occured in the calling thread.
      */
     virtual QString errorString() const = 0;
 
@@ -143,6 +314,23 @@ public:
      */
     virtual bool isValid() const = 0;
 
+    /**
+     * @brief Get firing lateness statistics.
+     * @return Histogram of lateness (notification time - event timestamp, in milliseconds)
+     *  of all events fired by the running timer since it was created.
+     *  Notifications made by the NOTIFY cleanup policy in start are not included.
+     * @pre -
+     */
+    virtual LatencyHistogram firingLateness() const = 0;
+
+    /**
+     * @brief Get runtime statistics.
+     * @return Snapshot of runtime counters. Counters are cheap to maintain and
+     *  always enabled. Getting queue depth requires a database query.
+     * @pre EventTimer is in a valid state.
+     */
+    virtual Statistics stats() const = 0;
+
     /**
      * @brief Start or restart scheduling events.
      * @param policy Declares policy on expired static events.
@@ -9,6 +9,7 @@
 #define EVENTTIMERBUILDER_HH
 
 #include "eventtimer.hh"
+#include "databaseprofile.hh"
 
 namespace EventTimerNS
 {
@@ -26,6 +27,11 @@ public:
      */
     struct Configuration
     {
+        /**
+         * @brief Constructor. Initializes optional parameters to their default values.
+         */
+        Configuration();
+
         /**
          * @brief Database type. Refer to QSqlDriver documentation for avalable type strings.
          */
@@ -63,13 +69,90 @@ public:
          * time and sets timer to it.
          */
         int refreshRateMsec;
+
+        /**
+         * @brief Use precise timer mode (default: false).
+         * In precise mode EventTimer arms a Qt::PreciseTimer against the monotonic clock
+         * and compensates for observed wake-up latency. With refreshRateMsec == 0
+         * events are fired as close to their timestamp as possible. With refreshRateMsec > 0
+         * polls are kept on a fixed grid, so that handler execution time does not
+         * accumulate as drift.
+         */
+        bool preciseTimer;
+
+        /**
+         * @brief Use adaptive refresh rate (default: false).
+         * Adaptive EventTimer sleeps until the next known event occurs, but polls
+         * the database at least every refreshRateMsec milliseconds. Idle timer
+         * with a long refresh rate rarely queries the database, while events
+         * are still fired on time under load. Value refreshRateMsec == 0 disables the
+         * periodic poll.
+         */
+        bool adaptiveRefresh;
+
+        /**
+         * @brief Timer slack in milliseconds (default: 0).
+         * When the timer is set to the next event (refreshRateMsec == 0 or adaptive refresh),
+         * events occuring within this window after the next event are fired in the
+         * same tick. Larger slack means fewer wake-ups and database queries at the
+         * cost of up to coalesceSlackMsec milliseconds of lateness.
+         */
+        int coalesceSlackMsec;
+
+        /**
+         * @brief Maximum number of events kept in memory for getEvent (default: 0, no caching).
+         * Recently added, updated or queried events are served without querying the database.
+         * Cache is kept up to date by the EventTimer, so it must be the only one modifying the table.
+         */
+        unsigned eventCacheSize;
+
+        /**
+         * @brief SQLite performance settings (default: SQLite defaults, every write is synced).
+         * Use DatabaseProfile presets to trade durability for write throughput.
+         * Ignored with other database types.
+         */
+        DatabaseProfile databaseProfile;
+
+        /**
+         * @brief Maximum number of read-only database connections (default: 0).
+         * When greater than 0, getEvent, nextEvents and eventsBetween may be called
+         * from other threads than the one running the EventTimer. Each calling thread
+         * gets its own connection, so that reads do not wait for the timer's writes
+         * (requires a database supporting concurrent readers, e.g. SQLite with WAL journal).
+         * Reads fail on threads that find every connection in use. In-memory databases
+         * can not be read from other threads.
+         * Logger must be thread-safe (e.g. AsyncLogger) when reading from other threads.
+         */
+        unsigned readerConnections;
+
+        /**
+         * @brief Maximum number of distinct event names kept in memory (default: 1024).
+         * Events read from the database share the memory of equal names, which saves memory
+         * when many events have the same name. Value 0 disables sharing.
+         */
+        unsigned namePoolSize;
+
+        /**
+         * @brief Key of the shared-memory schedule view (default: empty, no view).
+         * When set, EventTimer publishes its event count and the next scheduleViewSize
+         * events into shared memory after every change. Other processes read them with
+         * ScheduleView without querying the database. Each EventTimer must use its own key.
+         * If the schedule can not be loaded from the database, the view is not updated.
+         * EventTimer is invalid, if the shared memory cannot be created.
+         */
+        QString scheduleViewKey;
+
+        /**
+         * @brief Maximum number of upcoming events in the schedule view (default: 64).
+         */
+        unsigned scheduleViewSize;
     };
 
     /**
      * @brief Instantiate EventTimer component.
      * @param conf Configuration parameters.
      * @return New instance of EventTimer. Ownership is passed to the caller.
-     * @pre RefreshRate >= 0. Instantiate only one EventTimer using same table at the same time.
+     * @pre RefreshRate >= 0, coalesceSlackMsec >= 0. Instantiate only one EventTimer using same table at the same time.
      * @post New instance of EventTimer is created, but may not be in a valid state.
      *  Check validaty using EventTimer's isValid method. Discard invalid EventTimer.
      */
@@ -0,0 +1,108 @@
+/**
+ * @file
+ * @brief Defines the LatencyHistogram class, which collects
+ *  latency samples (such as event firing lateness) with low overhead.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef LATENCYHISTOGRAM_HH
+#define LATENCYHISTOGRAM_HH
+
+#include <QtGlobal>
+#include <vector>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief HDR-style log-linear histogram of non-negative latency values (in milliseconds).
+ *  Values below 128 are counted exactly. Larger values are counted in buckets
+ *  whose width is at most 1/64 of their lower bound, so recorded percentiles
+ *  have at most ~1.6% relative error. Recording a value does not allocate memory.
+ */
+class LatencyHistogram
+{
+public:
+
+    /**
+     * @brief Largest value that can be recorded. Larger values are clamped to this value.
+     */
+    static const qint64 MAX_VALUE;
+
+    /**
+     * @brief Constructor.
+     * @pre -
+     * @post Constructs an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Record single value.
+     * @param value Recorded value in milliseconds.
+     * @pre -
+     * @post Value is recorded. Negative values are recorded as 0,
+     *  and values larger than MAX_VALUE as MAX_VALUE.
+     */
+    void record(qint64 value);
+
+    /**
+     * @brief Remove all recorded values.
+     * @pre -
+     * @post Histogram is empty.
+     */
+    void reset();
+
+    /**
+     * @brief Get number of recorded values.
+     * @return Number of recorded values.
+     * @pre -
+     */
+    quint64 count() const;
+
+    /**
+     * @brief Get smallest recorded value.
+     * @return Smallest recorded value, or 0 if histogram is empty.
+     * @pre -
+     */
+    qint64 min() const;
+
+    /**
+     * @brief Get largest recorded value.
+     * @return Largest recorded value, or 0 if histogram is empty.
+     * @pre -
+     */
+    qint64 max() const;
+
+    /**
+     * @brief Get mean of recorded values.
+     * @return Mean of recorded values, or 0 if histogram is empty.
+     * @pre -
+     */
+    double mean() const;
+
+    /**
+     * @brief Get value at given percentile.
+     * @param percentile Percentile in range [0, 100] (e.g. 99.9 for p999).
+     * @return Smallest value v such that at least @p percentile percent of recorded
+     *  values are less than or equal to v (within histogram precision).
+     *  Returns 0 if histogram is empty.
+     * @pre 0 <= percentile <= 100.
+     */
+    qint64 percentile(double percentile) const;
+
+
+private:
+
+    std::vector<quint64> counts_;
+    quint64 count_;
+    qint64 min_;
+    qint64 max_;
+    double sum_;
+
+    static int bucketIndex(quint64 value);
+    static qint64 bucketUpperBound(int index);
+};
+
+} // namespace EventTimerNS
+
+#endif // LATENCYHISTOGRAM_HH
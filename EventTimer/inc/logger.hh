@@ -15,11 +15,22 @@ namespace EventTimerNS
 
 /**
  * @brief Interface for handling log messages. Component user provides implementation.
+ *  Implementing logMsg is sufficient. Override isEnabled to filter messages by level:
+ *  EventTimer formats a message only if the logger accepts its level.
  */
 class Logger
 {
 public:
 
+    /**
+     * @brief Log message severity levels in increasing order of severity.
+     *  Names are prefixed, because DEBUG and ERROR are common macros (e.g. -DDEBUG, windows.h).
+     */
+    enum Level
+    {
+        LEVEL_DEBUG, LEVEL_INFO, LEVEL_WARNING, LEVEL_ERROR
+    };
+
     /**
      * @brief Mandatory virtual destructor.
      */
@@ -32,6 +43,31 @@ public:
      * @post Logger implementation is expected to be re-entrant.
      */
     virtual void logMsg(const QString& msg) = 0;
+
+    /**
+     * @brief Check if messages of given level are logged.
+     * @param level Message level.
+     * @return True, if messages of @p level are accepted. Default implementation accepts all levels.
+     * @pre -
+     */
+    virtual bool isEnabled(Level level) const
+    {
+        Q_UNUSED(level);
+        return true;
+    }
+
+    /**
+     * @brief Write log message with level.
+     * @param level Message level.
+     * @param msg Logged message.
+     * @pre isEnabled(level) returned true.
+     * @post Default implementation passes the message to logMsg.
+     */
+    virtual void log(Level level, const QString& msg)
+    {
+        Q_UNUSED(level);
+        this->logMsg(msg);
+    }
 };
 
 } // namespace EventTimerNS
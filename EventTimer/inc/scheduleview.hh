@@ -0,0 +1,128 @@
+/**
+ * @file
+ * @brief Defines the ScheduleView class, a read-only view of an EventTimer's
+ *  upcoming events for other processes.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef SCHEDULEVIEW_HH
+#define SCHEDULEVIEW_HH
+
+#include <QString>
+#include <memory>
+#include <vector>
+
+class QSharedMemory;
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The ScheduleView class reads the upcoming events published by an
+ *  EventTimer configured with EventTimerBuilder::Configuration::scheduleViewKey.
+ *  View is read from shared memory, so monitoring processes can follow
+ *  the next deadlines and event count without querying the database.
+ *  Reading never blocks the EventTimer. ScheduleView is not thread-safe;
+ *  use one view per thread.
+ */
+class ScheduleView
+{
+public:
+
+    /**
+     * @brief Scheduled event.
+     */
+    struct Entry
+    {
+        /**
+         * @brief Event's id.
+         */
+        unsigned id;
+
+        /**
+         * @brief Event's due time (milliseconds since epoch).
+         */
+        qint64 dueMsec;
+    };
+
+    /**
+     * @brief Consistent copy of the published schedule.
+     */
+    struct State
+    {
+        /**
+         * @brief Update counter. Changes whenever EventTimer publishes an update.
+         */
+        unsigned generation;
+
+        /**
+         * @brief Total number of scheduled events.
+         */
+        unsigned eventCount;
+
+        /**
+         * @brief Time of the latest update (milliseconds since epoch).
+         */
+        qint64 publishedMsec;
+
+        /**
+         * @brief Earliest events in (due time, id) order. Holds up to
+         *  Configuration::scheduleViewSize events.
+         */
+        std::vector<Entry> upcoming;
+    };
+
+    /**
+     * @brief Constructor. Does not attach to the shared memory yet.
+     * @param key Configuration::scheduleViewKey of the EventTimer.
+     * @pre !key.isEmpty().
+     */
+    explicit ScheduleView(const QString& key);
+
+    /**
+     * @brief Destructor. Detaches from the shared memory.
+     */
+    ~ScheduleView();
+
+    ScheduleView(const ScheduleView&) = delete;
+    ScheduleView& operator=(const ScheduleView&) = delete;
+
+    /**
+     * @brief Attach to the shared memory of the EventTimer.
+     * @return True, if view is attached. Otherwise errorString() describes the error.
+     * @post View stays attached (and the shared memory exists) until the view is destroyed.
+     */
+    bool attach();
+
+    /**
+     * @brief Check if view is attached.
+     * @return True, if attach has succeeded.
+     */
+    bool isAttached() const;
+
+    /**
+     * @brief Read the published schedule. Copy is retried, if EventTimer
+     *  updates the schedule during the read.
+     * @param state Copy of the schedule is stored here. Storage of state.upcoming is reused.
+     * @param maxRetries Maximum number of retries.
+     * @return True, if a consistent copy was read. Otherwise errorString() describes the error.
+     * @pre View is attached. state != nullptr.
+     */
+    bool read(State* state, unsigned maxRetries = 1000);
+
+    /**
+     * @brief Get error message.
+     * @return Message describing the latest error.
+     */
+    QString errorString() const;
+
+
+private:
+
+    std::unique_ptr<QSharedMemory> memory_;
+    QString errorString_;
+};
+
+} // namespace EventTimerNS
+
+#endif // SCHEDULEVIEW_HH
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief Defines the TraceRecorder class, which collects timing spans of the
+ *  EventTimer engine and exports them in Chrome trace-event format.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef TRACERECORDER_HH
+#define TRACERECORDER_HH
+
+#include <QString>
+#include <QElapsedTimer>
+#include <vector>
+#include <atomic>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The TraceRecorder class stores spans (name, start time, duration
+ *  and thread) recorded by an EventTimer: timer checks, DatabaseHandler calls,
+ *  rescheduling of expired events and event handler notifications. Recorded
+ *  spans can be written as Chrome trace-event JSON, which can be opened in
+ *  chrome://tracing or Perfetto. Spans are stored in a buffer of fixed capacity.
+ *  When the buffer is full, further spans are dropped and counted.
+ *  Recording is thread-safe and lock-free.
+ *
+ *  When no recorder is set, tracing costs a pointer comparison per span.
+ *  If the library is built with systemtap's sys/sdt.h available, spans are also
+ *  exposed as static USDT probes 'eventtimer:span_begin' and 'eventtimer:span_end'
+ *  (argument: span name) for perf and bpftrace, whether a recorder is set or not.
+ */
+class TraceRecorder
+{
+public:
+
+    /**
+     * @brief Single recorded span.
+     */
+    struct Span
+    {
+        const char* name;       // Static string.
+        qint64 startNsec;       // From recorder construction or clear.
+        qint64 durationNsec;
+        quint64 threadId;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param capacity Maximum number of stored spans.
+     * @pre capacity > 0.
+     * @post Recorder is empty and its clock is started.
+     */
+    explicit TraceRecorder(unsigned capacity = 1000000);
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * @brief Get time from the recorder's clock.
+     * @return Nanoseconds since construction or last clear.
+     */
+    qint64 now() const;
+
+    /**
+     * @brief Record span ending now.
+     * @param name Span name. Must point to a string with static storage duration.
+     * @param startNsec Start time of the span from now().
+     * @post Span is stored, or dropped if buffer is full.
+     */
+    void record(const char* name, qint64 startNsec);
+
+    /**
+     * @brief Get number of stored spans.
+     * @return Number of spans that can be read.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Get number of dropped spans.
+     * @return Number of spans dropped, because buffer was full.
+     */
+    quint64 dropped() const;
+
+    /**
+     * @brief Get stored spans.
+     * @return Spans in the order they ended.
+     * @pre No spans are being recorded (e.g. timer is stopped).
+     */
+    std::vector<Span> spans() const;
+
+    /**
+     * @brief Remove all spans and restart the clock.
+     * @pre No spans are being recorded.
+     * @post Recorder is empty.
+     */
+    void clear();
+
+    /**
+     * @brief Write stored spans into a file as Chrome trace-event JSON.
+     * @param fileName Path of the file.
+     * @param error Error message is stored here if writing fails.
+     * @return True, if file was written.
+     * @pre No spans are being recorded.
+     */
+    bool writeChromeTrace(const QString& fileName, QString* error) const;
+
+private:
+
+    std::vector<Span> spans_;
+    std::atomic<unsigned> next_;     // Next free slot. Not advanced when buffer is full.
+    std::atomic<quint64> dropped_;
+    QElapsedTimer clock_;
+};
+
+} // namespace EventTimerNS
+
+#endif // TRACERECORDER_HH
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief Implements the AsyncLogger class defined in inc/asynclogger.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "asynclogger.hh"
+#include <QThread>
+#include <QMutexLocker>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief Background thread running AsyncLogger::run.
+ */
+class AsyncLogger::Worker : public QThread
+{
+public:
+
+    explicit Worker(AsyncLogger* owner) : QThread(), owner_(owner)
+    {
+    }
+
+protected:
+
+    virtual void run()
+    {
+        owner_->run();
+    }
+
+private:
+
+    AsyncLogger* owner_;
+};
+
+
+AsyncLogger::AsyncLogger(Logger* target, unsigned capacity, Level minLevel) :
+    Logger(), target_(target), minLevel_(minLevel), ring_(capacity),
+    head_(0), size_(0), inProgress_(0), stopping_(false), dropped_(0),
+    mutex_(), notEmpty_(), drained_(), worker_(new Worker(this))
+{
+    Q_ASSERT(target != nullptr);
+    Q_ASSERT(capacity > 0);
+    worker_->start();
+}
+
+
+AsyncLogger::~AsyncLogger()
+{
+    {
+        QMutexLocker lock(&mutex_);
+        stopping_ = true;
+        notEmpty_.wakeAll();
+    }
+    worker_->wait();
+}
+
+
+void AsyncLogger::logMsg(const QString& msg)
+{
+    this->log(LEVEL_INFO, msg);
+}
+
+
+bool AsyncLogger::isEnabled(Level level) const
+{
+    return level >= minLevel_ && target_->isEnabled(level);
+}
+
+
+void AsyncLogger::log(Level level, const QString& msg)
+{
+    if (level < minLevel_) return;
+
+    QMutexLocker lock(&mutex_);
+    if (size_ == ring_.size()){
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Entry& e = ring_[(head_ + size_) % ring_.size()];
+    e.level = level;
+    e.msg = msg;
+    ++size_;
+    notEmpty_.wakeOne();
+}
+
+
+void AsyncLogger::flush()
+{
+    QMutexLocker lock(&mutex_);
+    while (size_ != 0 || inProgress_ != 0){
+        drained_.wait(&mutex_);
+    }
+}
+
+
+quint64 AsyncLogger::droppedMessages() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+
+void AsyncLogger::run()
+{
+    std::vector<Entry> batch;
+    batch.reserve(ring_.size());
+
+    QMutexLocker lock(&mutex_);
+    while (true) {
+        while (size_ == 0 && !stopping_){
+            notEmpty_.wait(&mutex_);
+        }
+        if (size_ == 0) break;
+
+        // Take all queued messages and pass them to the target without holding the lock.
+        batch.clear();
+        while (size_ != 0){
+            Entry& e = ring_[head_];
+            batch.push_back(Entry{e.level, QString()});
+            batch.back().msg.swap(e.msg);
+            head_ = (head_ + 1) % ring_.size();
+            --size_;
+        }
+        inProgress_ = batch.size();
+
+        lock.unlock();
+        for (const Entry& e : batch){
+            target_->log(e.level, e.msg);
+        }
+        lock.relock();
+
+        inProgress_ = 0;
+        if (size_ == 0){
+            drained_.wakeAll();
+        }
+    }
+    drained_.wakeAll();
+}
+
+} // namespace EventTimerNS
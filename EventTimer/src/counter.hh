@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @brief Defines the Counter and ScopedTimer classes used for collecting
+ *  runtime statistics.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef COUNTER_HH
+#define COUNTER_HH
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <atomic>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief Statistics counter. Counter uses relaxed atomic operations,
+ *  so it is cheap to update and may be read from any thread.
+ */
+class Counter
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @post Counter value is 0.
+     */
+    Counter() : value_(0) {}
+
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    /**
+     * @brief Increment counter.
+     * @param amount Amount added to counter.
+     */
+    void add(quint64 amount = 1)
+    {
+        value_.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get counter value.
+     * @return Current value.
+     */
+    quint64 value() const
+    {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    std::atomic<quint64> value_;
+};
+
+
+/**
+ * @brief Adds time spent in the enclosing scope (in nanoseconds) to a counter.
+ */
+class ScopedTimer
+{
+public:
+
+    /**
+     * @brief Constructor. Starts measuring time.
+     * @param counter Counter that elapsed nanoseconds are added to on destruction.
+     */
+    explicit ScopedTimer(Counter& counter) : counter_(counter), timer_()
+    {
+        timer_.start();
+    }
+
+    /**
+     * @brief Destructor. Adds elapsed time to the counter.
+     */
+    ~ScopedTimer()
+    {
+        counter_.add(timer_.nsecsElapsed());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+
+    Counter& counter_;
+    QElapsedTimer timer_;
+};
+
+} // namespace EventTimerNS
+
+#endif // COUNTER_HH
@@ -5,21 +5,134 @@
  */
 
 #include "databasehandler.hh"
+#include "timestamp.hh"
+#include "tracespan.hh"
+#include "snapshot.hh"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QVariant>
-#include <QDateTime>
+#include <QStringList>
+#include <QThread>
+#include <QMutexLocker>
+#include <algorithm>
+#include <unordered_map>
 
 namespace EventTimerNS
 {
 
+namespace
+{
+
+/**
+ * @brief Decodes event rows of a query. Column indices are resolved once
+ *  per statement instead of looking up column names on every row.
+ */
+class EventRowDecoder
+{
+public:
+
+    EventRowDecoder(const QSqlQuery& q, NamePool* names) : names_(names)
+    {
+        QSqlRecord r = q.record();
+        id_ = r.indexOf("id");
+        name_ = r.indexOf("name");
+        timestamp_ = r.indexOf("timestamp");
+        interval_ = r.indexOf("interval");
+        repeats_ = r.indexOf("repeats");
+        static_ = r.indexOf("static");
+    }
+
+    // Decode current row of q into e.
+    void decode(const QSqlQuery& q, Event* e) const
+    {
+        e->setId(q.value(id_).toUInt());
+        e->setName(names_->intern(q.value(name_).toString()));
+        e->setTimestamp(q.value(timestamp_).toString());
+        e->setInterval(q.value(interval_).toUInt());
+        e->setRepeats(q.value(repeats_).toUInt());
+        e->setType(q.value(static_).toInt() == 0 ? Event::DYNAMIC : Event::STATIC);
+    }
+
+private:
+
+    NamePool* names_;
+    int id_;
+    int name_;
+    int timestamp_;
+    int interval_;
+    int repeats_;
+    int static_;
+};
+
+} // Anonymous namespace
+
+
+/**
+ * @brief Connection for a read-only query. Writer thread uses the writer connection,
+ *  which is locked for the lifetime of ReadConnection. Other threads get their own
+ *  connection from the pool, because Qt connections may be used only in the thread
+ *  that created them. If no reader connection is available, connection is invalid
+ *  and handler's error string is set.
+ */
+class DatabaseHandler::ReadConnection
+{
+public:
+
+    explicit ReadConnection(DatabaseHandler* handler) :
+        db_(), mutex_(nullptr)
+    {
+        if (QThread::currentThread() == handler->writerThread_){
+            mutex_ = &handler->writerMutex_;
+            mutex_->lock();
+            db_ = handler->db_;
+        } else {
+            db_ = handler->readerConnection();
+        }
+    }
+
+    ~ReadConnection()
+    {
+        if (mutex_ != nullptr) mutex_->unlock();
+    }
+
+    ReadConnection(const ReadConnection&) = delete;
+    ReadConnection& operator=(const ReadConnection&) = delete;
+
+    bool isValid() const
+    {
+        return db_.isValid();
+    }
+
+    QSqlDatabase& database()
+    {
+        return db_;
+    }
+
+private:
+
+    QSqlDatabase db_;
+    QMutex* mutex_;
+};
+
+
 const QString DatabaseHandler::CONNECTION_STRING_("EventTimerDbConnection");
-int DatabaseHandler::connectionCount_(0);
+QAtomicInt DatabaseHandler::connectionCount_(0);
+const unsigned DatabaseHandler::MAX_IDS_PER_STATEMENT_(500);
+
+DatabaseHandler::DbSetup::DbSetup() :
+    dbType(), dbName(), tableName(), dbHostName(), userName(), password(),
+    cacheSize(0), profile(), readerConnections(0), namePoolSize(1024)
+{
+}
+
 
 DatabaseHandler::DatabaseHandler(const DbSetup& setup) :
 
-    db_(), errorString_(), errorFlag_(false), tableName_(setup.tableName)
+    db_(), errorStrings_(), errorFlag_(false), tableName_(setup.tableName), stats_(),
+    cache_(setup.cacheSize), names_(setup.namePoolSize), setup_(setup), connectionName_(),
+    writerThread_(QThread::currentThread()), writerMutex_(), errorMutex_(),
+    readersMutex_(), readers_(), readerCount_(0), tracer_(nullptr)
 {
     Q_ASSERT(!setup.dbType.isEmpty());
     Q_ASSERT(!setup.dbName.isEmpty());
@@ -31,6 +144,27 @@ DatabaseHandler::DatabaseHandler(const DbSetup& setup) :
 DatabaseHandler::~DatabaseHandler()
 {
     db_.close();
+
+    for (const QString& name : readers_){
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+
+void DatabaseHandler::releaseReaderConnection()
+{
+    QString name;
+    {
+        QMutexLocker lock(&readersMutex_);
+        name = readers_.take(QThread::currentThread());
+    }
+    {
+        QMutexLocker lock(&errorMutex_);
+        errorStrings_.remove(QThread::currentThread());
+    }
+    if (!name.isEmpty()){
+        QSqlDatabase::removeDatabase(name);
+    }
 }
 
 
@@ -42,7 +176,10 @@ bool DatabaseHandler::isValid() const
 
 QString DatabaseHandler::errorString() const
 {
-    return errorString_;
+    // Initialization errors concern every thread.
+    QThread* thread = this->isValid() ? QThread::currentThread() : writerThread_;
+    QMutexLocker lock(&errorMutex_);
+    return errorStrings_.value(thread);
 }
 
 
@@ -51,7 +188,11 @@ unsigned DatabaseHandler::addEvent(Event* e)
     Q_ASSERT(e != nullptr);
     Q_ASSERT(e->id() == Event::UNASSIGNED_ID);
     Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::addEvent");
+    QMutexLocker lock(&writerMutex_);
 
+    stats_.insertStatements.add();
     QSqlQuery q("INSERT INTO " + tableName_ +
                 " (name, timestamp, interval, repeats, static)"
                 " VALUES('" + e->name() + "', '" + e->timestamp() + "', " +
@@ -61,15 +202,17 @@ unsigned DatabaseHandler::addEvent(Event* e)
                 ")", db_);
 
     if (q.lastError().type() != QSqlError::NoError) {
-        errorString_ = q.lastError().text();
+        this->setErrorString(q.lastError().text());
         return -1;
     }
 
     // Find out the id of latest insertion (hackish).
+    stats_.selectStatements.add();
     QSqlQuery q2("SELECT MAX(id) FROM " + tableName_, db_);
     q2.next();
     int latestId = q2.value(0).toInt();
     e->setId(latestId);
+    cache_.put(*e);
     return latestId;
 }
 
@@ -77,45 +220,186 @@ unsigned DatabaseHandler::addEvent(Event* e)
 bool DatabaseHandler::removeEvent(unsigned eventId)
 {
     Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::removeEvent");
+    QMutexLocker lock(&writerMutex_);
 
+    stats_.deleteStatements.add();
     QSqlQuery q("DELETE FROM " + tableName_ + " WHERE id = " + QString::number(eventId), db_);
     if (q.lastError().type() != QSqlError::NoError) {
-        errorString_ = q.lastError().text();
+        this->setErrorString(q.lastError().text());
+        return false;
+    }
+    cache_.remove(eventId);
+    return true;
+}
+
+
+bool DatabaseHandler::removeEvents(const std::vector<unsigned>& eventIds, unsigned* removed)
+{
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::removeEvents");
+    QMutexLocker lock(&writerMutex_);
+
+    if (removed != nullptr) *removed = 0;
+    if (eventIds.empty()) return true;
+
+    // Driver may not support transactions. Then chunks are committed separately.
+    bool transaction = db_.transaction();
+
+    // Delete in chunks to keep statements within database's length limits.
+    unsigned deleted = 0;
+    for (unsigned begin = 0; begin < eventIds.size(); begin += MAX_IDS_PER_STATEMENT_){
+        unsigned end = qMin(unsigned(eventIds.size()), begin + MAX_IDS_PER_STATEMENT_);
+        stats_.deleteStatements.add();
+        QSqlQuery q("DELETE FROM " + tableName_ + " WHERE id IN (" +
+                    idList(eventIds, begin, end) + ")", db_);
+        if (q.lastError().type() != QSqlError::NoError) {
+            this->setErrorString(q.lastError().text());
+            if (transaction) db_.rollback();
+            return false;
+        }
+        // Driver returns -1, if it cannot tell the number of affected rows.
+        deleted += unsigned(qMax(0, q.numRowsAffected()));
+    }
+
+    if (transaction && !db_.commit()){
+        this->setErrorString(db_.lastError().text());
+        db_.rollback();
         return false;
     }
+
+    for (unsigned id : eventIds){
+        cache_.remove(id);
+    }
+    if (removed != nullptr) *removed = deleted;
     return true;
 }
 
 
 std::vector<Event> DatabaseHandler::nextEvents(QString time, unsigned amount)
 {
-    Q_ASSERT( QDateTime::fromString(time, Event::TIME_FORMAT).isValid() );
+    Q_ASSERT( Timestamp::isValid(time) );
     Q_ASSERT( amount != 0 );
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::nextEvents");
 
     // Execute query.
-    QSqlQuery q("SELECT * FROM " + tableName_ + " WHERE timestamp > '" + time + "' ORDER BY timestamp", db_);
-    if (q.lastError().type() != QSqlError::NoError){
-        errorString_ = q.lastError().text();
+    ReadConnection connection(this);
+    if (!connection.isValid()) return std::vector<Event>();
+    QSqlQuery q(connection.database());
+    if (!this->selectEvents(q, " WHERE timestamp > '" + time + "'"
+                               " ORDER BY timestamp LIMIT " + QString::number(amount))){
         return std::vector<Event>();
     }
 
     // Gather list of up to 'amount' events from query results.
     std::vector<Event> events;
-    unsigned i=0;
-    while (i<amount && q.next()){
+    events.reserve(qMin(amount, 1024u));
+    EventRowDecoder decoder(q, &names_);
+    while (q.next()){
+        events.emplace_back();
+        decoder.decode(q, &events.back());
+        Q_ASSERT(events.back().isValid());
+    }
+    stats_.rowsScanned.add(events.size());
+
+    this->setErrorString(QString());
+    return events;
+}
+
+
+std::vector<Event> DatabaseHandler::eventsBetween(const QString& from, const QString& to, unsigned limit,
+                                                  const QString& afterTimestamp, unsigned afterId)
+{
+    Q_ASSERT(this->isValid());
+    Q_ASSERT(Timestamp::isValid(from));
+    Q_ASSERT(Timestamp::isValid(to));
+    Q_ASSERT(limit != 0);
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::eventsBetween");
+
+    // Seek past the previous page instead of skipping rows with OFFSET.
+    QString clauses = " WHERE timestamp >= '" + from + "' AND timestamp < '" + to + "'";
+    if (!afterTimestamp.isEmpty()){
+        clauses += " AND (timestamp > '" + afterTimestamp + "'"
+                   " OR (timestamp = '" + afterTimestamp + "' AND id > " + QString::number(afterId) + "))";
+    }
+    clauses += " ORDER BY timestamp, id LIMIT " + QString::number(limit);
+
+    ReadConnection connection(this);
+    if (!connection.isValid()) return std::vector<Event>();
+    QSqlQuery q(connection.database());
+    if (!this->selectEvents(q, clauses)){
+        return std::vector<Event>();
+    }
+
+    std::vector<Event> events;
+    events.reserve(qMin(limit, 1024u));
+    EventRowDecoder decoder(q, &names_);
+    while (q.next()){
+        events.emplace_back();
+        decoder.decode(q, &events.back());
+    }
+    stats_.rowsScanned.add(events.size());
+
+    this->setErrorString(QString());
+    return events;
+}
+
+
+std::vector<Event> DatabaseHandler::getEvents(const std::vector<unsigned>& eventIds)
+{
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::getEvents");
+
+    // Take cached events, and collect the rest for querying.
+    std::vector<Event> events(eventIds.size());
+    std::vector<unsigned> missing;
+    std::unordered_map<unsigned, unsigned> positions;
+    quint64 generation = cache_.generation();
+    for (unsigned i = 0; i < eventIds.size(); ++i){
+        if (cache_.find(eventIds[i], &events[i])){
+            stats_.cacheHits.add();
+        }
+        else {
+            stats_.cacheMisses.add();
+            missing.push_back(eventIds[i]);
+            positions.emplace(eventIds[i], i);
+        }
+    }
+
+    if (missing.empty()){
+        this->setErrorString(QString());
+        return events;
+    }
+
+    ReadConnection connection(this);
+    if (!connection.isValid()) return std::vector<Event>();
+    for (unsigned begin = 0; begin < missing.size(); begin += MAX_IDS_PER_STATEMENT_){
+        unsigned end = qMin(unsigned(missing.size()), begin + MAX_IDS_PER_STATEMENT_);
+        QSqlQuery q(connection.database());
+        if (!this->selectEvents(q, " WHERE id IN (" + idList(missing, begin, end) + ")")){
+            return std::vector<Event>();
+        }
+
+        EventRowDecoder decoder(q, &names_);
         Event e;
-        e.setId( q.value("id").toUInt() );
-        e.setName( q.value("name").toString() );
-        e.setTimestamp( q.value("timestamp").toString() );
-        e.setType( q.value("static").toInt() == 0 ? Event::DYNAMIC : Event::STATIC );
-        e.setInterval( q.value("interval").toUInt() );
-        e.setRepeats( q.value("repeats").toUInt() );
-        Q_ASSERT(e.isValid());
-        events.push_back(e);
-        ++i;
-    }
-
-    errorString_.clear();
+        while (q.next()){
+            decoder.decode(q, &e);
+            events[positions[e.id()]] = e;
+            cache_.putIfUnchanged(e, generation);
+            stats_.rowsScanned.add();
+        }
+    }
+
+    // Drop ids that were not found.
+    events.erase(std::remove_if(events.begin(), events.end(),
+                                [](const Event& e){ return e.id() == Event::UNASSIGNED_ID; }),
+                 events.end());
+    this->setErrorString(QString());
     return events;
 }
 
@@ -123,12 +407,17 @@ std::vector<Event> DatabaseHandler::nextEvents(QString time, unsigned amount)
 bool DatabaseHandler::clearDynamic()
 {
     Q_ASSERT (this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::clearDynamic");
+    QMutexLocker lock(&writerMutex_);
 
+    stats_.deleteStatements.add();
     QSqlQuery q("DELETE FROM " + tableName_ + " WHERE static = 0", db_);
     if (q.lastError().type() != QSqlError::NoError) {
-        errorString_ = q.lastError().text();
+        this->setErrorString(q.lastError().text());
         return false;
     }
+    cache_.removeType(Event::DYNAMIC);
     return true;
 }
 
@@ -136,49 +425,81 @@ bool DatabaseHandler::clearDynamic()
 bool DatabaseHandler::clearAll()
 {
     Q_ASSERT (this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::clearAll");
+    QMutexLocker lock(&writerMutex_);
 
+    stats_.deleteStatements.add();
     QSqlQuery q("DELETE FROM " + tableName_, db_);
     if (q.lastError().type() != QSqlError::NoError) {
-        errorString_ = q.lastError().text();
+        this->setErrorString(q.lastError().text());
         return false;
     }
+    cache_.clear();
+    names_.clear();
     return true;
 }
 
 
 std::vector<Event> DatabaseHandler::checkOccured(const QString& time)
 {
-    Q_ASSERT(QDateTime::fromString(time, Event::TIME_FORMAT).isValid());
+    Q_ASSERT(Timestamp::isValid(time));
     Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::checkOccured");
+    QMutexLocker lock(&writerMutex_);
 
     // Fetch event data.
-    QSqlQuery q("SELECT * FROM " + tableName_ +
-                " WHERE timestamp < '" + time + "'", db_);
-
-    if (q.lastError().type() != QSqlError::NoError) {
-        errorString_ = q.lastError().text();
+    QSqlQuery q(db_);
+    if (!this->selectEvents(q, " WHERE timestamp < '" + time + "' ORDER BY timestamp, id")) {
         return std::vector<Event>();
     }
 
     // Parse events.
     std::vector<Event> events;
+    EventRowDecoder decoder(q, &names_);
     while (q.next()) {
-        Event e(q.value("name").toString(),
-                q.value("timestamp").toString(),
-                q.value("static").toString() == "1" ? Event::STATIC : Event::DYNAMIC,
-                q.value("interval").toUInt(),
-                q.value("repeats").toUInt());
-        e.setId(q.value("id").toInt());
-        events.push_back(e);
+        events.emplace_back();
+        decoder.decode(q, &events.back());
     }
+    stats_.rowsScanned.add(events.size());
     return events;
 }
 
 
+bool DatabaseHandler::checkOccured(const QString& time, EventBatch* batch)
+{
+    Q_ASSERT(Timestamp::isValid(time));
+    Q_ASSERT(batch != nullptr);
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::checkOccured");
+    QMutexLocker lock(&writerMutex_);
+
+    batch->clear();
+    QSqlQuery q(db_);
+    if (!this->selectEvents(q, " WHERE timestamp < '" + time + "' ORDER BY timestamp, id")) {
+        return false;
+    }
+
+    EventRowDecoder decoder(q, &names_);
+    while (q.next()) {
+        decoder.decode(q, batch->append());
+    }
+    batch->decodeDueTimes();
+    stats_.rowsScanned.add(batch->size());
+    return true;
+}
+
+
 bool DatabaseHandler::updateEvent(unsigned eventID, const Event& e)
 {
     Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::updateEvent");
+    QMutexLocker lock(&writerMutex_);
 
+    stats_.updateStatements.add();
     QSqlQuery q("UPDATE "+ tableName_ +
                 " SET name = "  + "'" + e.name() + "'," +
                 " timestamp = " + "'" + e.timestamp() + "'," +
@@ -189,54 +510,436 @@ bool DatabaseHandler::updateEvent(unsigned eventID, const Event& e)
                 db_);
 
     if (q.lastError().type() != QSqlError::NoError){
-        errorString_ = q.lastError().text();
+        this->setErrorString(q.lastError().text());
         return false;
     }
+
+    // Update cached copy. Event is not cached here, because it may not exist.
+    Event cached(e);
+    cached.setId(eventID);
+    cache_.update(cached);
     return true;
 }
 
 
-Event DatabaseHandler::getEvent(unsigned eventId)
+bool DatabaseHandler::rescheduleEvent(unsigned eventId, const QString& timestamp,
+                                      unsigned interval, unsigned repeats)
 {
     Q_ASSERT(this->isValid());
+    Q_ASSERT(Timestamp::isValid(timestamp));
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::rescheduleEvent");
+    QMutexLocker lock(&writerMutex_);
+
+    // Same rule as Event::isValid. Repeating events without interval can not be scheduled.
+    if (repeats != 0 && interval == 0){
+        this->setErrorString("Repeating event must have an interval.");
+        return false;
+    }
 
-    QSqlQuery q("SELECT id, name, timestamp, interval, repeats, static "
-                "FROM " + tableName_ + " WHERE id = " + QString::number(eventId),
+    stats_.updateStatements.add();
+    QSqlQuery q("UPDATE " + tableName_ +
+                " SET timestamp = '" + timestamp + "',"
+                " interval = " + QString::number(interval) + ","
+                " repeats = "  + QString::number(repeats) +
+                " WHERE id = " + QString::number(eventId),
                 db_);
 
+    if (q.lastError().type() != QSqlError::NoError){
+        this->setErrorString(q.lastError().text());
+        return false;
+    }
+    if (q.numRowsAffected() == 0){
+        this->setErrorString("No such event.");
+        return false;
+    }
+    cache_.reschedule(eventId, timestamp, interval, repeats);
+    this->setErrorString(QString());
+    return true;
+}
+
+
+bool DatabaseHandler::rescheduleEvents(const std::vector<unsigned>& eventIds, const QString& timestamp,
+                                       unsigned interval, unsigned repeats)
+{
+    Q_ASSERT(this->isValid());
+    Q_ASSERT(Timestamp::isValid(timestamp));
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::rescheduleEvents");
+    QMutexLocker lock(&writerMutex_);
+
+    if (eventIds.empty()) return true;
+
+    bool transaction = db_.transaction();
+    QString assignments = " SET timestamp = '" + timestamp + "',"
+                          " interval = " + QString::number(interval) + ","
+                          " repeats = "  + QString::number(repeats);
+
+    for (unsigned begin = 0; begin < eventIds.size(); begin += MAX_IDS_PER_STATEMENT_){
+        unsigned end = qMin(unsigned(eventIds.size()), begin + MAX_IDS_PER_STATEMENT_);
+        stats_.updateStatements.add();
+        QSqlQuery q("UPDATE " + tableName_ + assignments +
+                    " WHERE id IN (" + idList(eventIds, begin, end) + ")", db_);
+        if (q.lastError().type() != QSqlError::NoError) {
+            this->setErrorString(q.lastError().text());
+            if (transaction) db_.rollback();
+            return false;
+        }
+    }
+
+    if (transaction && !db_.commit()){
+        this->setErrorString(db_.lastError().text());
+        db_.rollback();
+        return false;
+    }
+
+    for (unsigned id : eventIds){
+        cache_.reschedule(id, timestamp, interval, repeats);
+    }
+    return true;
+}
+
+
+Event DatabaseHandler::getEvent(unsigned eventId)
+{
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::getEvent");
+
+    Event cached;
+    if (cache_.find(eventId, &cached)){
+        stats_.cacheHits.add();
+        this->setErrorString(QString());
+        return cached;
+    }
+    stats_.cacheMisses.add();
+    quint64 generation = cache_.generation();
+
+    ReadConnection connection(this);
+    if (!connection.isValid()) return Event();
+    QSqlQuery q(connection.database());
+
     // Query failed.
-    if (q.lastError().type() != QSqlError::NoError) {
-        errorString_ = q.lastError().text();
-        return Event("Query Failed", "2000-01-01 00:00:00:000", Event::DYNAMIC);
+    if (!this->selectEvents(q, " WHERE id = " + QString::number(eventId))) {
+        return Event();
     }
 
     // No results.
     if (!q.next()){
-        errorString_ = "";
-        return Event("Not Found", "2000-01-01 00:00:00:000", Event::DYNAMIC);
+        this->setErrorString(QString());
+        return Event();
     }
 
     // Create event.
-    Event e(q.value("name").toString(),
-            q.value("timestamp").toString(),
-            (q.value("static").toString() == "1" ? Event::STATIC : Event::DYNAMIC),
-            q.value("interval").toInt(), q.value("repeats").toInt());
-    e.setId(q.value("id").toInt());
+    Event e;
+    EventRowDecoder(q, &names_).decode(q, &e);
+    cache_.putIfUnchanged(e, generation);
     return e;
 }
 
 
-void DatabaseHandler::openDB(const DbSetup& setup)
+quint64 DatabaseHandler::eventCount()
+{
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::eventCount");
+
+    ReadConnection connection(this);
+    if (!connection.isValid()) return 0;
+    stats_.selectStatements.add();
+    QSqlQuery q("SELECT COUNT(*) FROM " + tableName_, connection.database());
+    if (q.lastError().type() != QSqlError::NoError || !q.next()) {
+        this->setErrorString(q.lastError().text());
+        return 0;
+    }
+    return q.value(0).toULongLong();
+}
+
+
+std::vector<std::pair<unsigned, qint64> > DatabaseHandler::eventDueTimes()
+{
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::eventDueTimes");
+    QMutexLocker lock(&writerMutex_);
+
+    stats_.selectStatements.add();
+    QSqlQuery q(db_);
+    q.setForwardOnly(true);
+    q.exec("SELECT id, timestamp FROM " + tableName_ + " ORDER BY timestamp");
+    if (q.lastError().type() != QSqlError::NoError){
+        this->setErrorString(q.lastError().text());
+        return std::vector<std::pair<unsigned, qint64> >();
+    }
+
+    std::vector<unsigned> ids;
+    std::vector<QString> timestamps;
+    while (q.next()){
+        ids.push_back(q.value(0).toUInt());
+        timestamps.push_back(q.value(1).toString());
+    }
+    stats_.rowsScanned.add(ids.size());
+
+    std::vector<qint64> times(timestamps.size());
+    Timestamp::parseBatch(timestamps.data(), timestamps.size(), times.data());
+    std::vector<std::pair<unsigned, qint64> > rv;
+    rv.reserve(ids.size());
+    for (unsigned i = 0; i < ids.size(); ++i){
+        if (times[i] != Timestamp::INVALID_TIME){
+            rv.emplace_back(ids[i], times[i]);
+        }
+    }
+    this->setErrorString(QString());
+    return rv;
+}
+
+
+bool DatabaseHandler::exportSnapshot(QIODevice* device)
+{
+    Q_ASSERT(device != nullptr);
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::exportSnapshot");
+    QMutexLocker lock(&writerMutex_);
+
+    QSqlQuery q(db_);
+    if (!this->selectEvents(q, " ORDER BY timestamp, id")){
+        return false;
+    }
+
+    // Rows are streamed to the device one at a time.
+    SnapshotWriter writer(device);
+    EventRowDecoder decoder(q, &names_);
+    Event e;
+    quint64 rows = 0;
+    while (q.next()){
+        decoder.decode(q, &e);
+        ++rows;
+        if (!writer.write(e)){
+            stats_.rowsScanned.add(rows);
+            this->setErrorString(writer.errorString());
+            return false;
+        }
+    }
+    stats_.rowsScanned.add(rows);
+
+    if (!writer.finish()){
+        this->setErrorString(writer.errorString());
+        return false;
+    }
+    this->setErrorString(QString());
+    return true;
+}
+
+
+bool DatabaseHandler::importSnapshot(QIODevice* device)
+{
+    Q_ASSERT(device != nullptr);
+    Q_ASSERT(this->isValid());
+    ScopedTimer timer(stats_.timeNsec);
+    TraceSpan span(tracer_, "DatabaseHandler::importSnapshot");
+    QMutexLocker lock(&writerMutex_);
+
+    SnapshotReader reader(device);
+    if (!reader.isValid()){
+        this->setErrorString(reader.errorString());
+        return false;
+    }
+
+    // Driver may not support transactions. Then rows are committed separately.
+    bool transaction = db_.transaction();
+
+    // Statement is prepared once and executed for every event.
+    QSqlQuery q(db_);
+    bool ok = q.prepare("INSERT INTO " + tableName_ +
+                        " (id, name, timestamp, interval, repeats, static)"
+                        " VALUES (?, ?, ?, ?, ?, ?)");
+    Event e;
+    while (ok && reader.read(&e)){
+        stats_.insertStatements.add();
+        q.addBindValue(e.id());
+        q.addBindValue(e.name());
+        q.addBindValue(e.timestamp());
+        q.addBindValue(e.interval());
+        q.addBindValue(e.repeats());
+        q.addBindValue(e.type() == Event::STATIC ? 1 : 0);
+        ok = q.exec();
+    }
+
+    if (!ok || !reader.atEnd()){
+        this->setErrorString(ok ? reader.errorString() : q.lastError().text());
+        if (transaction) db_.rollback();
+        return false;
+    }
+
+    if (transaction && !db_.commit()){
+        this->setErrorString(db_.lastError().text());
+        db_.rollback();
+        return false;
+    }
+    cache_.invalidate();
+    this->setErrorString(QString());
+    return true;
+}
+
+
+void DatabaseHandler::setTraceRecorder(TraceRecorder* recorder)
 {
-    db_ = QSqlDatabase::addDatabase(setup.dbType, CONNECTION_STRING_ + QString::number(connectionCount_));
-    ++connectionCount_;
-    db_.setDatabaseName(setup.dbName);
+    tracer_ = recorder;
+}
 
-    if (!setup.dbHostName.isEmpty()) db_.setHostName(setup.dbHostName);
-    if (!setup.userName.isEmpty())   db_.setUserName(setup.userName);
-    if (!setup.password.isEmpty())   db_.setPassword(setup.password);
+
+const DatabaseHandler::Statistics& DatabaseHandler::statistics() const
+{
+    return stats_;
+}
+
+
+QString DatabaseHandler::idList(const std::vector<unsigned>& ids, unsigned begin, unsigned end)
+{
+    QString list;
+    list.reserve(11 * (end - begin));
+    for (unsigned i = begin; i < end; ++i){
+        if (i != begin) list += ',';
+        list += QString::number(ids[i]);
+    }
+    return list;
+}
+
+
+bool DatabaseHandler::selectEvents(QSqlQuery& q, const QString& clauses)
+{
+    stats_.selectStatements.add();
+
+    // Rows are read once in order, so driver does not need to buffer results.
+    q.setForwardOnly(true);
+    q.exec("SELECT id, name, timestamp, interval, repeats, static FROM " + tableName_ + clauses);
+
+    if (q.lastError().type() != QSqlError::NoError){
+        this->setErrorString(q.lastError().text());
+        return false;
+    }
+    return true;
+}
+
+
+bool DatabaseHandler::applyProfile(QSqlDatabase& db, const DatabaseProfile& profile, bool reader)
+{
+    // Busy timeout first, so that changing the journal mode waits for other connections.
+    QStringList pragmas;
+    if (profile.busyTimeoutMsec >= 0){
+        pragmas << "busy_timeout = " + QString::number(profile.busyTimeoutMsec);
+    }
+    // Journal mode is stored in the database file by the writer.
+    if (!profile.journalMode.isEmpty() && !reader){
+        pragmas << "journal_mode = " + profile.journalMode;
+    }
+    if (!profile.synchronous.isEmpty()){
+        pragmas << "synchronous = " + profile.synchronous;
+    }
+    if (profile.mmapSize >= 0){
+        pragmas << "mmap_size = " + QString::number(profile.mmapSize);
+    }
+    if (profile.cacheSizeKib != 0){
+        // Negative cache size is in kibibytes instead of pages.
+        pragmas << "cache_size = -" + QString::number(profile.cacheSizeKib);
+    }
+
+    for (const QString& pragma : pragmas){
+        QSqlQuery q("PRAGMA " + pragma, db);
+        if (q.lastError().type() != QSqlError::NoError){
+            this->setErrorString(q.lastError().text());
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void DatabaseHandler::configure(QSqlDatabase& db) const
+{
+    db.setDatabaseName(setup_.dbName);
+    if (!setup_.dbHostName.isEmpty()) db.setHostName(setup_.dbHostName);
+    if (!setup_.userName.isEmpty())   db.setUserName(setup_.userName);
+    if (!setup_.password.isEmpty())   db.setPassword(setup_.password);
+}
+
+
+QSqlDatabase DatabaseHandler::readerConnection()
+{
+    QThread* thread = QThread::currentThread();
+    Q_ASSERT(thread != writerThread_);
+    // In-memory databases are private to their connection.
+    if (setup_.dbName == ":memory:"){
+        this->setErrorString("In-memory database can be read only from the thread that created the DatabaseHandler.");
+        return QSqlDatabase();
+    }
+
+    QMutexLocker lock(&readersMutex_);
+    auto it = readers_.find(thread);
+    if (it != readers_.end()){
+        return QSqlDatabase::database(it.value(), false);
+    }
+    if (unsigned(readers_.size()) >= setup_.readerConnections){
+        this->setErrorString("No reader connection available for thread (" +
+                             QString::number(setup_.readerConnections) + " in use).");
+        return QSqlDatabase();
+    }
+
+    // Open a new connection owned by the calling thread.
+    QString name = connectionName_ + "_reader" + QString::number(readerCount_++);
+    bool opened = false;
+    QString errorString;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(setup_.dbType, name);
+        this->configure(db);
+        if (db.driverName() == "QSQLITE"){
+            db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        }
+        if (!db.open()){
+            errorString = db.lastError().text();
+        }
+        else if (db.driverName() == "QSQLITE" && !this->applyProfile(db, setup_.profile, true)){
+            errorString = this->errorString();
+        }
+        else {
+            opened = true;
+        }
+    }
+    if (!opened){
+        this->setErrorString("Could not open reader connection: " + errorString);
+        QSqlDatabase::removeDatabase(name);
+        return QSqlDatabase();
+    }
+
+    readers_.insert(thread, name);
+    return QSqlDatabase::database(name, false);
+}
+
+
+void DatabaseHandler::setErrorString(const QString& error)
+{
+    QMutexLocker lock(&errorMutex_);
+    if (error.isEmpty()){
+        errorStrings_.remove(QThread::currentThread());
+    } else {
+        errorStrings_.insert(QThread::currentThread(), error);
+    }
+}
+
+
+void DatabaseHandler::openDB(const DbSetup& setup)
+{
+    connectionName_ = CONNECTION_STRING_ + QString::number(connectionCount_.fetchAndAddRelaxed(1));
+    db_ = QSqlDatabase::addDatabase(setup.dbType, connectionName_);
+    this->configure(db_);
 
     if (db_.open()) {
+        if (db_.driverName() == "QSQLITE" && !this->applyProfile(db_, setup.profile, false)){
+            errorFlag_ = true;
+            return;
+        }
+
         // Create table id not created.
         QSqlQuery q("CREATE TABLE IF NOT EXISTS " + tableName_ +
                     " (id INTEGER PRIMARY KEY,"
@@ -245,12 +948,24 @@ void DatabaseHandler::openDB(const DbSetup& setup)
                     db_);
 
         if (q.lastError().type() != QSqlError::NoError) {
-            errorString_ = q.lastError().text();
+            this->setErrorString(q.lastError().text());
             errorFlag_ = true;
+            return;
+        }
+
+        // Expiry checks and range queries scan by time. Index only speeds up queries,
+        // so failure leaves the handler valid. Error string tells why it is missing.
+        if (db_.driverName() == "QSQLITE" || db_.driverName() == "QPSQL"){
+            QSqlQuery index("CREATE INDEX IF NOT EXISTS " + tableName_ + "_timestamp_idx"
+                            " ON " + tableName_ + " (timestamp, id)",
+                            db_);
+            if (index.lastError().type() != QSqlError::NoError) {
+                this->setErrorString("Could not create timestamp index: " + index.lastError().text());
+            }
         }
     }
     else {
-        errorString_ = db_.lastError().text();
+        this->setErrorString(db_.lastError().text());
     }
 }
 
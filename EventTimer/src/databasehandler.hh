@@ -10,14 +10,35 @@
 
 #include <QString>
 #include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QMutex>
+#include <QHash>
+#include <QAtomicInt>
 #include <vector>
+#include <utility>
 #include "event.hh"
+#include "databaseprofile.hh"
+#include "counter.hh"
+#include "eventcache.hh"
+#include "namepool.hh"
+#include "eventbatch.hh"
+#include "tracerecorder.hh"
+
+class QThread;
+class QIODevice;
 
 namespace EventTimerNS
 {
 
 /**
  * @brief The DatabaseHandler class takes care of making transactions in the database.
+ *  Modifying methods, checkOccured and eventDueTimes must be called from the thread
+ *  that created the DatabaseHandler (writer thread). Read-only methods (getEvent,
+ *  getEvents, nextEvents, eventsBetween and eventCount) may be called from any thread.
+ *  Each reader thread gets its own read-only connection (up to DbSetup::readerConnections),
+ *  so reads run concurrently with the writer on databases supporting it (e.g. SQLite in WAL mode).
+ *  Reads fail on threads that get no connection. Error string is kept per thread,
+ *  so a failure in one thread is not seen as a failure by another.
  */
 class DatabaseHandler
 {
@@ -28,6 +49,11 @@ public:
      */
     struct DbSetup
     {
+        /**
+         * @brief Constructor. Initializes optional parameters to their default values.
+         */
+        DbSetup();
+
         /**
          * @brief Database type string (refer to QtSql documentation for available type strings.
          */
@@ -57,6 +83,79 @@ public:
          * @brief Database password. Leave empty if not required.
          */
         QString password;
+
+        /**
+         * @brief Maximum number of events cached for getEvent (default: 0, no caching).
+         *  Cache is kept up to date by this DatabaseHandler only, so enable it only
+         *  if no one else modifies the table.
+         */
+        unsigned cacheSize;
+
+        /**
+         * @brief SQLite performance settings (default: SQLite defaults).
+         */
+        DatabaseProfile profile;
+
+        /**
+         * @brief Maximum number of read-only connections for reader threads (default: 0).
+         *  Each thread other than the writer thread needs its own connection. When none is
+         *  available, reads from that thread fail. In-memory databases can not be read from
+         *  other threads.
+         */
+        unsigned readerConnections;
+
+        /**
+         * @brief Maximum number of distinct event names shared between queried events (default: 1024).
+         *  Value 0 disables sharing.
+         */
+        unsigned namePoolSize;
+    };
+
+
+    /**
+     * @brief Runtime statistics of database operations.
+     */
+    struct Statistics
+    {
+        /**
+         * @brief Number of executed INSERT statements.
+         */
+        Counter insertStatements;
+
+        /**
+         * @brief Number of executed DELETE statements.
+         */
+        Counter deleteStatements;
+
+        /**
+         * @brief Number of executed UPDATE statements.
+         */
+        Counter updateStatements;
+
+        /**
+         * @brief Number of executed SELECT statements.
+         */
+        Counter selectStatements;
+
+        /**
+         * @brief Number of result rows read by queries returning multiple events.
+         */
+        Counter rowsScanned;
+
+        /**
+         * @brief Number of getEvent calls served from the cache.
+         */
+        Counter cacheHits;
+
+        /**
+         * @brief Number of getEvent calls that queried the database.
+         */
+        Counter cacheMisses;
+
+        /**
+         * @brief Time spent in DatabaseHandler operations (in nanoseconds).
+         */
+        Counter timeNsec;
     };
 
 
@@ -85,6 +184,14 @@ public:
      */
     DatabaseHandler& operator=(const DatabaseHandler&) = delete;
 
+    /**
+     * @brief Close the calling thread's reader connection. Call this before a reader
+     *  thread exits. Otherwise the connection is closed in destructor.
+     * @pre Called from a reader thread that does not have queries in progress.
+     * @post Reader connection of the calling thread is closed and its error string is cleared.
+     */
+    void releaseReaderConnection();
+
     /**
      * @brief Check if DatabaseHandler is in a valid state.
      * @return True, if current state is valid. If state is invalid, error
@@ -95,7 +202,8 @@ public:
 
     /**
      * @brief Get error message.
-     * @return Message describing latest occured error.
+     * @return Message describing latest error occured in the calling thread.
+     *  If DatabaseHandler is invalid, returns the initialization error in every thread.
      */
     QString errorString() const;
 
@@ -120,6 +228,19 @@ public:
      */
     bool removeEvent(unsigned eventId);
 
+    /**
+     * @brief Remove multiple events from the database in a single transaction.
+     * @param eventIds Id-numbers of removed events. Ids that do not match
+     *  any event are ignored.
+     * @param removed If not nullptr, number of deleted rows is stored here.
+     * @return True, if events were removed successfully.
+     * @pre DatabaseHandler is in a valid state.
+     * @post All events are removed, or database is not modified (if the
+     *  database driver supports transactions). In case of error,
+     *  returns false and updates error string.
+     */
+    bool removeEvents(const std::vector<unsigned>& eventIds, unsigned* removed = nullptr);
+
     /**
      * @brief Get list of next events occuring after given time.
      * @param time Start time.
@@ -131,6 +252,35 @@ public:
      */
     std::vector<Event> nextEvents(QString time, unsigned amount);
 
+    /**
+     * @brief Get one page of events occuring within a time range, ordered by (timestamp, id).
+     *  On SQLite and PostgreSQL the query uses the (timestamp, id) index, so every page costs the same.
+     *  Other databases need the index created manually.
+     * @param from Start of the range (inclusive).
+     * @param to End of the range (exclusive).
+     * @param limit Maximum number of events on the page.
+     * @param afterTimestamp Timestamp of the last event on the previous page.
+     *  Empty string for the first page.
+     * @param afterId Id of the last event on the previous page.
+     * @return Vector of up to @p limit events.
+     * @pre DatabaseHandler is in a valid state. @p from and @p to (and @p afterTimestamp,
+     *  if not empty) are in valid format (Event::TIME_FORMAT). limit != 0.
+     * @post If query fails, returns empty vector and updates errorString().
+     */
+    std::vector<Event> eventsBetween(const QString& from, const QString& to, unsigned limit,
+                                     const QString& afterTimestamp = QString(),
+                                     unsigned afterId = 0);
+
+    /**
+     * @brief Get multiple events by id. Cached events are not queried from the database.
+     * @param eventIds Id numbers of events.
+     * @return Found events in the order of @p eventIds. Ids that do not match
+     *  any event are skipped.
+     * @pre DatabaseHandler is in a valid state.
+     * @post If query fails, returns empty vector and updates errorString().
+     */
+    std::vector<Event> getEvents(const std::vector<unsigned>& eventIds);
+
     /**
      * @brief Remove all dynamic events from the database.
      * @return True, if all dynamic events were removed successfully.
@@ -152,11 +302,23 @@ public:
     /**
      * @brief Check for occured events.
      * @param time Inspected time.
-     * @return Events occured before given time.
+     * @return Events occured before given time, ordered by timestamp.
      * @pre time is in valid format (Event::TIME_FORMAT) and represents a valid datetime.
      */
     std::vector<Event> checkOccured(const QString& time);
 
+    /**
+     * @brief Check for occured events, reusing the storage of @p batch.
+     * @param time Inspected time.
+     * @param batch Events occured before given time, ordered by timestamp, are stored here.
+     *  Due times of the events are decoded in bulk (EventBatch::dueTime).
+     * @return True, if query succeeded. Otherwise returns false, batch is empty
+     *  and error string is updated.
+     * @pre time is in valid format (Event::TIME_FORMAT) and represents a valid datetime.
+     *  batch != nullptr.
+     */
+    bool checkOccured(const QString& time, EventBatch* batch);
+
     /**
      * @brief Update event name, time, type, interval and repeats.
      * @param eventID Id-number of the original event.
@@ -169,27 +331,157 @@ public:
     bool updateEvent(unsigned eventID, const Event& e);
 
     /**
-     * @brief Get event matching the id number.
+     * @brief Change event's occurence time, interval and repeats. Name, type and id are kept.
+     * @param eventId Id-number of the event.
+     * @param timestamp New occurence time.
+     * @param interval New repeat interval in milliseconds.
+     * @param repeats New number of repeats.
+     * @return True, if event was updated. If no such event exists, returns false
+     *  and sets error string to "No such event.". If @p repeats != 0 and @p interval == 0,
+     *  returns false without modifying the database.
+     * @pre DatabaseHandler is in a valid state. @p timestamp is in valid format
+     *  (Event::TIME_FORMAT) and represents a valid datetime. repeats == 0 || interval != 0.
+     * @post Updates the event or does not modify the database.
+     *  In case of error returns false and updates the error string.
+     */
+    bool rescheduleEvent(unsigned eventId, const QString& timestamp,
+                         unsigned interval, unsigned repeats);
+
+    /**
+     * @brief Give multiple events the same occurence time, interval and repeats
+     *  in a single transaction. Name, type and id are kept.
+     * @param eventIds Id-numbers of the events. Ids that do not match any event are ignored.
+     * @param timestamp New occurence time.
+     * @param interval New repeat interval in milliseconds.
+     * @param repeats New number of repeats.
+     * @return True, if events were updated successfully.
+     * @pre DatabaseHandler is in a valid state. @p timestamp is in valid format
+     *  (Event::TIME_FORMAT) and represents a valid datetime.
+     * @post All events are updated, or database is not modified (if the
+     *  database driver supports transactions). In case of error,
+     *  returns false and updates error string.
+     */
+    bool rescheduleEvents(const std::vector<unsigned>& eventIds, const QString& timestamp,
+                          unsigned interval, unsigned repeats);
+
+    /**
+     * @brief Get event matching the id number. Recently used events are served from the cache.
      * @param eventId Searched id number.
      * @return Event matching the id number. If no such event exists or query fails,
-     *  returns event with id = -1. Extra information is available calling errorString().
+     *  returns default constructed Event (id is unassigned). If no such event exists,
+     *  error string is empty. Otherwise errorString() describes the error.
      * @pre id > 0. DatabaseHandler is in a valid state.
      */
     Event getEvent(unsigned eventId);
 
+    /**
+     * @brief Count events in the database.
+     * @return Number of scheduled events. In case of error, returns 0 and updates error string.
+     * @pre DatabaseHandler is in a valid state.
+     */
+    quint64 eventCount();
+
+    /**
+     * @brief Get ids and occurence times of all events. Timestamps are
+     *  converted in bulk with Timestamp::parseBatch.
+     * @return Vector of (id, milliseconds since epoch) pairs. Events with invalid
+     *  timestamps are left out. In case of error, returns empty vector and
+     *  updates error string.
+     * @pre DatabaseHandler is in a valid state.
+     */
+    std::vector<std::pair<unsigned, qint64> > eventDueTimes();
+
+    /**
+     * @brief Write all events into a binary snapshot (see snapshot.hh),
+     *  ordered by (timestamp, id). Rows are streamed, so the whole table
+     *  is never held in memory.
+     * @param device Output device.
+     * @return True, if snapshot was written. In case of error, returns false
+     *  and updates error string.
+     * @pre device != nullptr and is open for writing. DatabaseHandler is in a valid state.
+     */
+    bool exportSnapshot(QIODevice* device);
+
+    /**
+     * @brief Insert events of a binary snapshot in a single transaction with a
+     *  prepared statement. Event ids are kept. Due times are stored as UTC in the
+     *  snapshot, and are converted to local time of this machine.
+     * @param device Input device.
+     * @return True, if all events were imported. Fails, if snapshot is corrupted
+     *  or an id is already in use.
+     * @pre device != nullptr and is open for reading. DatabaseHandler is in a valid state.
+     * @post All events are added, or database is not modified (if the database driver
+     *  supports transactions). In case of error, returns false and updates error string.
+     */
+    bool importSnapshot(QIODevice* device);
+
+    /**
+     * @brief Set recorder for tracing spans of DatabaseHandler calls.
+     * @param recorder Trace recorder, or nullptr to disable tracing.
+     *  DatabaseHandler does not take ownership over the recorder.
+     * @pre No other thread is using the DatabaseHandler.
+     */
+    void setTraceRecorder(TraceRecorder* recorder);
+
+    /**
+     * @brief Get runtime statistics.
+     * @return Statistics of operations made by this DatabaseHandler.
+     * @pre -
+     */
+    const Statistics& statistics() const;
+
 
 private:
 
+    class ReadConnection;
+
     QSqlDatabase db_;
-    QString errorString_;
+    QHash<QThread*, QString> errorStrings_;
     bool errorFlag_;
     QString tableName_;
+    Statistics stats_;
+    EventCache cache_;
+    NamePool names_;
+    DbSetup setup_;
+    QString connectionName_;
+    QThread* writerThread_;
+    QMutex writerMutex_;
+    // Guards errorStrings_.
+    mutable QMutex errorMutex_;
+
+    // Reader connection names by thread.
+    QMutex readersMutex_;
+    QHash<QThread*, QString> readers_;
+    unsigned readerCount_;
+
+    TraceRecorder* tracer_;
 
     static const QString CONNECTION_STRING_;
-    static int connectionCount_;
+    static QAtomicInt connectionCount_;
+    static const unsigned MAX_IDS_PER_STATEMENT_;
 
 
     void openDB(const DbSetup& setup);
+
+    // Set connection parameters of db according to setup.
+    void configure(QSqlDatabase& db) const;
+
+    // Apply SQLite pragmas of profile. Returns false and sets error string on failure.
+    bool applyProfile(QSqlDatabase& db, const DatabaseProfile& profile, bool reader);
+
+    // Get calling thread's reader connection. Returns invalid connection and sets
+    // error string, if no connection is available. Must not be called by the writer thread.
+    QSqlDatabase readerConnection();
+
+    // Set error string of the calling thread.
+    void setErrorString(const QString& error);
+
+    // Execute forward-only SELECT of event columns followed by clauses (WHERE, ORDER BY...).
+    // Returns false and sets error string, if query fails.
+    bool selectEvents(QSqlQuery& q, const QString& clauses);
+
+    // Comma separated list of ids [begin, end) for IN clauses.
+    static QString idList(const std::vector<unsigned>& ids, unsigned begin, unsigned end);
 };
 
 } // namespace EventTimerNS
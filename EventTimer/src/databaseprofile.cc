@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Implements the DatabaseProfile struct defined in inc/databaseprofile.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "databaseprofile.hh"
+
+namespace EventTimerNS
+{
+
+DatabaseProfile::DatabaseProfile() :
+    journalMode(), synchronous(), mmapSize(-1), cacheSizeKib(0), busyTimeoutMsec(-1)
+{
+}
+
+
+DatabaseProfile DatabaseProfile::durable()
+{
+    DatabaseProfile p;
+    p.journalMode = "WAL";
+    p.synchronous = "FULL";
+    p.busyTimeoutMsec = 5000;
+    return p;
+}
+
+
+DatabaseProfile DatabaseProfile::balanced()
+{
+    DatabaseProfile p;
+    p.journalMode = "WAL";
+    p.synchronous = "NORMAL";
+    p.mmapSize = 64 * 1024 * 1024;
+    p.cacheSizeKib = 8 * 1024;
+    p.busyTimeoutMsec = 5000;
+    return p;
+}
+
+
+DatabaseProfile DatabaseProfile::fast()
+{
+    DatabaseProfile p;
+    p.journalMode = "MEMORY";
+    p.synchronous = "OFF";
+    p.mmapSize = 256 * 1024 * 1024;
+    p.cacheSizeKib = 32 * 1024;
+    p.busyTimeoutMsec = 5000;
+    return p;
+}
+
+} // namespace EventTimerNS
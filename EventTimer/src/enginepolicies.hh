@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief Defines the clock, storage and dispatch policies of EventTimerCore.
+ *  Policies are plain classes with inline methods, so that calls made by
+ *  the core are resolved at compile time.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef ENGINEPOLICIES_HH
+#define ENGINEPOLICIES_HH
+
+#include <QDateTime>
+#include <QString>
+#include <vector>
+#include "databasehandler.hh"
+#include "eventbatch.hh"
+#include "eventhandler.hh"
+#include "timestamp.hh"
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief Clock policy reading the system wall clock.
+ */
+class SystemClock
+{
+public:
+
+    /**
+     * @brief Get current time.
+     * @return Milliseconds since epoch.
+     */
+    qint64 nowMsec() const
+    {
+        return QDateTime::currentMSecsSinceEpoch();
+    }
+};
+
+
+/**
+ * @brief Clock policy whose time is moved explicitly. Time does not pass
+ *  by itself, so expiry processing is deterministic.
+ */
+class VirtualClock
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @param startMsec Initial time (milliseconds since epoch).
+     */
+    explicit VirtualClock(qint64 startMsec = 0) : now_(startMsec)
+    {
+    }
+
+    /**
+     * @brief Get current time.
+     * @return Milliseconds since epoch.
+     */
+    qint64 nowMsec() const
+    {
+        return now_;
+    }
+
+    /**
+     * @brief Set current time.
+     * @param msec Milliseconds since epoch.
+     */
+    void set(qint64 msec)
+    {
+        now_ = msec;
+    }
+
+    /**
+     * @brief Move time forward.
+     * @param msec Milliseconds.
+     * @pre msec >= 0.
+     */
+    void advance(qint64 msec)
+    {
+        Q_ASSERT(msec >= 0);
+        now_ += msec;
+    }
+
+private:
+
+    qint64 now_;
+};
+
+
+/**
+ * @brief Storage policy keeping events in the database through a DatabaseHandler.
+ *  Storage policies provide checkOccured, rescheduleEvents, removeEvents and errorString
+ *  with the signatures below.
+ */
+class SqlStorage
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @param db Used DatabaseHandler. Storage does not take ownership over it.
+     * @pre db != nullptr.
+     */
+    explicit SqlStorage(DatabaseHandler* db) : db_(db)
+    {
+        Q_ASSERT(db != nullptr);
+    }
+
+    /**
+     * @brief Get events due before @p nowMsec ordered by (due time, id).
+     *  Due times of the batch are decoded.
+     * @return True, if query succeeded.
+     */
+    bool checkOccured(qint64 nowMsec, EventBatch* batch)
+    {
+        return db_->checkOccured(Timestamp::format(nowMsec), batch);
+    }
+
+    /**
+     * @brief Give events a new due time, interval and repeats.
+     * @return True, if events were updated.
+     */
+    bool rescheduleEvents(const std::vector<unsigned>& eventIds, qint64 dueMsec,
+                          unsigned interval, unsigned repeats)
+    {
+        return db_->rescheduleEvents(eventIds, Timestamp::format(dueMsec), interval, repeats);
+    }
+
+    /**
+     * @brief Remove events.
+     * @return True, if events were removed.
+     */
+    bool removeEvents(const std::vector<unsigned>& eventIds)
+    {
+        return db_->removeEvents(eventIds);
+    }
+
+    /**
+     * @brief Get message describing the latest error.
+     */
+    QString errorString() const
+    {
+        return db_->errorString();
+    }
+
+private:
+
+    DatabaseHandler* db_;
+};
+
+
+/**
+ * @brief Dispatch policy notifying an EventHandler.
+ */
+class HandlerDispatch
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @param handler Notified handler. Dispatch does not take ownership over it.
+     */
+    explicit HandlerDispatch(EventHandler* handler = nullptr) : handler_(handler)
+    {
+    }
+
+    /**
+     * @brief Set notified handler.
+     */
+    void setHandler(EventHandler* handler)
+    {
+        handler_ = handler;
+    }
+
+    /**
+     * @brief Notify handler about occured event.
+     * @pre Handler has been set.
+     */
+    void notify(const Event& e)
+    {
+        Q_ASSERT(handler_ != nullptr);
+        handler_->notify(e);
+    }
+
+private:
+
+    EventHandler* handler_;
+};
+
+} // namespace EventTimerNS
+
+#endif // ENGINEPOLICIES_HH
@@ -6,7 +6,7 @@
 
 #include "event.hh"
 #include <limits>
-#include <QDateTime>
+#include "timestamp.hh"
 
 namespace EventTimerNS
 {
@@ -130,7 +130,7 @@ void Event::setId(unsigned id)
 bool Event::isValid() const
 {
     return !name_.isEmpty() &&
-            QDateTime::fromString(timestamp_, TIME_FORMAT).isValid() &&
+            Timestamp::isValid(timestamp_) &&
             (repeats_ == 0 || interval_ != 0);
 }
 
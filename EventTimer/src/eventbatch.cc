@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief Implements the EventBatch class defined in src/eventbatch.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "eventbatch.hh"
+#include "timestamp.hh"
+
+namespace EventTimerNS
+{
+
+EventBatch::EventBatch() :
+    events_(), size_(0), timestamps_(), dueTimes_()
+{
+}
+
+
+void EventBatch::clear()
+{
+    size_ = 0;
+}
+
+
+Event* EventBatch::append()
+{
+    if (size_ == events_.size()){
+        events_.emplace_back();
+    }
+    return &events_[size_++];
+}
+
+
+unsigned EventBatch::size() const
+{
+    return size_;
+}
+
+
+bool EventBatch::empty() const
+{
+    return size_ == 0;
+}
+
+
+const Event& EventBatch::at(unsigned i) const
+{
+    Q_ASSERT(i < size_);
+    return events_[i];
+}
+
+
+void EventBatch::decodeDueTimes()
+{
+    timestamps_.resize(size_);
+    dueTimes_.resize(size_);
+    for (unsigned i = 0; i < size_; ++i){
+        timestamps_[i] = events_[i].timestamp();
+    }
+    Timestamp::parseBatch(timestamps_.data(), size_, dueTimes_.data());
+}
+
+
+qint64 EventBatch::dueTime(unsigned i) const
+{
+    Q_ASSERT(i < size_);
+    Q_ASSERT(i < dueTimes_.size());
+    return dueTimes_[i];
+}
+
+
+const Event* EventBatch::begin() const
+{
+    return events_.data();
+}
+
+
+const Event* EventBatch::end() const
+{
+    return events_.data() + size_;
+}
+
+} // namespace EventTimerNS
@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @brief Defines the EventBatch class, a reusable container for events read in one query.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef EVENTBATCH_HH
+#define EVENTBATCH_HH
+
+#include "event.hh"
+#include <vector>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The EventBatch class holds events returned by a single query.
+ *  Clearing the batch keeps the Event objects and storage, and appending
+ *  reuses them. A batch reused for every timer tick therefore allocates
+ *  only when it grows beyond its largest earlier size. Due times of the
+ *  events can be decoded in bulk after the batch has been filled.
+ */
+class EventBatch
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @post Batch is empty.
+     */
+    EventBatch();
+
+    /**
+     * @brief Remove all events. Storage is kept for reuse.
+     * @post Batch is empty.
+     */
+    void clear();
+
+    /**
+     * @brief Append event to the batch.
+     * @return Pointer to the appended event. Event holds the values of an earlier,
+     *  cleared event, so caller must set all of its fields. Pointer is valid until
+     *  next call to append.
+     * @post Batch size is increased by one.
+     */
+    Event* append();
+
+    /**
+     * @brief Get number of events.
+     * @return Number of events in the batch.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Check if batch is empty.
+     * @return True, if there are no events in the batch.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get event.
+     * @param i Index of the event.
+     * @return Event at index @p i.
+     * @pre i < size().
+     */
+    const Event& at(unsigned i) const;
+
+    /**
+     * @brief Convert timestamps of all events into due times with Timestamp::parseBatch.
+     * @post dueTime returns due time of each event until batch is modified.
+     */
+    void decodeDueTimes();
+
+    /**
+     * @brief Get due time of an event.
+     * @param i Index of the event.
+     * @return Event's timestamp in milliseconds since epoch, or Timestamp::INVALID_TIME
+     *  if timestamp is invalid.
+     * @pre i < size(). decodeDueTimes has been called after the last append.
+     */
+    qint64 dueTime(unsigned i) const;
+
+    /**
+     * @brief Iterator to the first event.
+     */
+    const Event* begin() const;
+
+    /**
+     * @brief Iterator past the last event.
+     */
+    const Event* end() const;
+
+
+private:
+
+    std::vector<Event> events_;
+    unsigned size_;
+    std::vector<QString> timestamps_;   // Decoding input, kept for reuse.
+    std::vector<qint64> dueTimes_;
+};
+
+} // namespace EventTimerNS
+
+#endif // EVENTBATCH_HH
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @brief Implements the EventCache class defined in src/eventcache.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "eventcache.hh"
+#include <iterator>
+#include <QMutexLocker>
+
+namespace EventTimerNS
+{
+
+EventCache::EventCache(unsigned capacity) :
+    mutex_(), generation_(0), capacity_(capacity), events_(), index_()
+{
+    index_.reserve(capacity);
+}
+
+
+bool EventCache::find(unsigned eventId, Event* e)
+{
+    Q_ASSERT(e != nullptr);
+    if (capacity_ == 0) return false;
+
+    QMutexLocker lock(&mutex_);
+    auto it = index_.find(eventId);
+    if (it == index_.end()) return false;
+
+    events_.splice(events_.begin(), events_, it->second);
+    *e = events_.front();
+    return true;
+}
+
+
+bool EventCache::contains(unsigned eventId) const
+{
+    QMutexLocker lock(&mutex_);
+    return index_.find(eventId) != index_.end();
+}
+
+
+void EventCache::put(const Event& e)
+{
+    Q_ASSERT(e.id() != Event::UNASSIGNED_ID);
+    if (capacity_ == 0) return;
+
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    this->insert(e);
+}
+
+
+void EventCache::putIfUnchanged(const Event& e, quint64 generation)
+{
+    Q_ASSERT(e.id() != Event::UNASSIGNED_ID);
+    if (capacity_ == 0) return;
+
+    QMutexLocker lock(&mutex_);
+    if (generation_ == generation){
+        this->insert(e);
+    }
+}
+
+
+void EventCache::update(const Event& e)
+{
+    Q_ASSERT(e.id() != Event::UNASSIGNED_ID);
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    auto it = index_.find(e.id());
+    if (it == index_.end()) return;
+
+    *(it->second) = e;
+}
+
+
+void EventCache::invalidate()
+{
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+}
+
+
+quint64 EventCache::generation() const
+{
+    QMutexLocker lock(&mutex_);
+    return generation_;
+}
+
+
+void EventCache::reschedule(unsigned eventId, const QString& timestamp,
+                            unsigned interval, unsigned repeats)
+{
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    auto it = index_.find(eventId);
+    if (it == index_.end()) return;
+
+    Event& e = *(it->second);
+    e.setTimestamp(timestamp);
+    e.setInterval(interval);
+    e.setRepeats(repeats);
+}
+
+
+void EventCache::remove(unsigned eventId)
+{
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    auto it = index_.find(eventId);
+    if (it == index_.end()) return;
+
+    events_.erase(it->second);
+    index_.erase(it);
+}
+
+
+void EventCache::removeType(Event::Type type)
+{
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    for (auto it = events_.begin(); it != events_.end(); ){
+        if (it->type() == type){
+            index_.erase(it->id());
+            it = events_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+
+void EventCache::clear()
+{
+    QMutexLocker lock(&mutex_);
+    ++generation_;
+    events_.clear();
+    index_.clear();
+}
+
+
+unsigned EventCache::size() const
+{
+    QMutexLocker lock(&mutex_);
+    return index_.size();
+}
+
+
+void EventCache::insert(const Event& e)
+{
+    auto it = index_.find(e.id());
+    if (it != index_.end()){
+        *(it->second) = e;
+        events_.splice(events_.begin(), events_, it->second);
+        return;
+    }
+
+    if (index_.size() == capacity_){
+        // Re-use the least recently used node.
+        index_.erase(events_.back().id());
+        events_.splice(events_.begin(), events_, std::prev(events_.end()));
+        events_.front() = e;
+    }
+    else {
+        events_.push_front(e);
+    }
+    index_.emplace(e.id(), events_.begin());
+}
+
+} // namespace EventTimerNS
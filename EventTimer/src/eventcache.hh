@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @brief Defines the EventCache class, a bounded least-recently-used cache of events.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef EVENTCACHE_HH
+#define EVENTCACHE_HH
+
+#include "event.hh"
+#include <QMutex>
+#include <list>
+#include <unordered_map>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The EventCache class stores up to capacity events by their id.
+ *  When the cache is full, the least recently used event is discarded.
+ *  EventCache is thread-safe.
+ */
+class EventCache
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @param capacity Maximum number of cached events. Capacity 0 disables caching.
+     * @post Cache is empty.
+     */
+    explicit EventCache(unsigned capacity);
+
+    /**
+     * @brief Get cached event.
+     * @param eventId Event's id.
+     * @param e Cached event is copied here.
+     * @return True, if event was cached.
+     * @pre e != nullptr.
+     * @post Event becomes the most recently used one.
+     */
+    bool find(unsigned eventId, Event* e);
+
+    /**
+     * @brief Check if event is cached.
+     * @param eventId Event's id.
+     * @return True, if event is cached.
+     */
+    bool contains(unsigned eventId) const;
+
+    /**
+     * @brief Add or replace cached event.
+     * @param e Cached event.
+     * @pre e has an assigned id.
+     * @post Event is cached, if capacity > 0. Least recently used event
+     *  is discarded, if the cache was full.
+     */
+    void put(const Event& e);
+
+    /**
+     * @brief Add event read from the database, unless the cache has been
+     *  modified after the read started.
+     * @param e Cached event.
+     * @param generation Value of generation() before reading the event.
+     * @pre e has an assigned id.
+     * @post Event is cached, if no modifications were made in between.
+     *  Otherwise cache is not modified, because the event may be out of date.
+     */
+    void putIfUnchanged(const Event& e, quint64 generation);
+
+    /**
+     * @brief Replace event changed in the database. Event is not added, if it is not cached.
+     * @param e New values of the event.
+     * @pre e has an assigned id.
+     * @post Cached copy, if any, is replaced. Modification counter is incremented
+     *  even if the event was not cached, so that concurrent reads of the old
+     *  values are not cached by putIfUnchanged.
+     */
+    void update(const Event& e);
+
+    /**
+     * @brief Mark the database modified without changing cached events.
+     *  Used when written events can not be cached yet.
+     * @post Modification counter is incremented.
+     */
+    void invalidate();
+
+    /**
+     * @brief Get modification counter. Counter is incremented whenever the
+     *  database is modified through the cache owner.
+     * @return Current modification count.
+     */
+    quint64 generation() const;
+
+    /**
+     * @brief Change occurence time, interval and repeats of a cached event.
+     * @param eventId Event's id.
+     * @param timestamp New timestamp.
+     * @param interval New interval.
+     * @param repeats New repeats.
+     * @post If event is cached, its values are updated.
+     */
+    void reschedule(unsigned eventId, const QString& timestamp,
+                    unsigned interval, unsigned repeats);
+
+    /**
+     * @brief Remove event from the cache.
+     * @param eventId Event's id.
+     * @post Event is not cached.
+     */
+    void remove(unsigned eventId);
+
+    /**
+     * @brief Remove all events of given type.
+     * @param type Removed event type.
+     * @post No events of type @p type are cached.
+     */
+    void removeType(Event::Type type);
+
+    /**
+     * @brief Remove all events.
+     * @post Cache is empty.
+     */
+    void clear();
+
+    /**
+     * @brief Get number of cached events.
+     * @return Number of cached events.
+     */
+    unsigned size() const;
+
+
+private:
+
+    typedef std::list<Event> EventList;
+
+    // Caller holds mutex_.
+    void insert(const Event& e);
+
+    mutable QMutex mutex_;
+    quint64 generation_;
+    unsigned capacity_;
+    EventList events_; // Most recently used first.
+    std::unordered_map<unsigned, EventList::iterator> index_;
+};
+
+} // namespace EventTimerNS
+
+#endif // EVENTCACHE_HH
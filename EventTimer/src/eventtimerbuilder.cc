@@ -12,6 +12,16 @@
 namespace EventTimerNS
 {
 
+EventTimerBuilder::Configuration::Configuration() :
+    dbType(), dbName(), tableName(), dbHostName(), userName(), password(),
+    refreshRateMsec(1000), preciseTimer(false),
+    adaptiveRefresh(false), coalesceSlackMsec(0), eventCacheSize(0),
+    databaseProfile(), readerConnections(0), namePoolSize(1024),
+    scheduleViewKey(), scheduleViewSize(64)
+{
+}
+
+
 EventTimer*EventTimerBuilder::create(const EventTimerBuilder::Configuration& conf)
 {
     DatabaseHandler::DbSetup setup;
@@ -21,9 +31,21 @@ EventTimer*EventTimerBuilder::create(const EventTimerBuilder::Configuration& con
     setup.dbHostName = conf.dbHostName;
     setup.userName = conf.userName;
     setup.password = conf.password;
+    setup.cacheSize = conf.eventCacheSize;
+    setup.profile = conf.databaseProfile;
+    setup.readerConnections = conf.readerConnections;
+    setup.namePoolSize = conf.namePoolSize;
+
+    EventTimerLogic::TimerSetup timerSetup;
+    timerSetup.refreshRate = conf.refreshRateMsec;
+    timerSetup.preciseTimer = conf.preciseTimer;
+    timerSetup.adaptiveRefresh = conf.adaptiveRefresh;
+    timerSetup.coalesceSlack = conf.coalesceSlackMsec;
+    timerSetup.scheduleViewKey = conf.scheduleViewKey;
+    timerSetup.scheduleViewSize = conf.scheduleViewSize;
 
     std::unique_ptr<DatabaseHandler> dbHandler(new DatabaseHandler(setup));
-    return new EventTimerLogic(std::move(dbHandler), conf.refreshRateMsec);
+    return new EventTimerLogic(std::move(dbHandler), timerSetup);
 }
 
 } // namespace EventTimerNS
@@ -0,0 +1,298 @@
+/**
+ * @file
+ * @brief Defines the EventTimerCore class template, the expiry processing
+ *  engine of EventTimerLogic parameterized on clock, storage and dispatch policies.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef EVENTTIMERCORE_HH
+#define EVENTTIMERCORE_HH
+
+#include <QString>
+#include <algorithm>
+#include <vector>
+#include "event.hh"
+#include "eventbatch.hh"
+#include "scheduleindex.hh"
+#include "counter.hh"
+#include "latencyhistogram.hh"
+#include "logger.hh"
+#include "tracerecorder.hh"
+#include "tracespan.hh"
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The EventTimerCore class finds occured events, moves repeating events
+ *  to their next occurence, removes finished events and dispatches the occured
+ *  events. It also keeps the in-memory schedule index in sync with the storage.
+ *  Policies are resolved at compile time, so the tick path is free of virtual calls:
+ *   - Clock: qint64 nowMsec() (see SystemClock, VirtualClock).
+ *   - Storage: checkOccured, rescheduleEvents, removeEvents and errorString (see SqlStorage).
+ *   - Dispatch: void notify(const Event&) (see HandlerDispatch).
+ *  EventTimerLogic uses EventTimerCore<SystemClock, SqlStorage, HandlerDispatch>.
+ */
+template <typename Clock, typename Storage, typename Dispatch>
+class EventTimerCore
+{
+public:
+
+    /**
+     * @brief Delay (in milliseconds) before events that could not be updated
+     *  in the storage are checked again.
+     */
+    static const qint64 RETRY_DELAY_MSEC = 1000;
+
+    /**
+     * @brief Counters updated by the core.
+     */
+    struct Counters
+    {
+        Counter handlerTimeNsec;
+        Counter eventsFired;
+        Counter eventsRescheduled;
+        Counter eventsRemoved;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param clock Clock policy.
+     * @param storage Storage policy.
+     * @param dispatch Dispatch policy.
+     * @post Schedule index is empty. Logging and tracing are disabled.
+     */
+    EventTimerCore(const Clock& clock, const Storage& storage, const Dispatch& dispatch) :
+        clock_(clock), storage_(storage), dispatch_(dispatch), schedule_(), counters_(),
+        lateness_(), logger_(nullptr), tracer_(nullptr), order_(), group_(), finished_()
+    {
+    }
+
+    EventTimerCore(const EventTimerCore&) = delete;
+    EventTimerCore& operator=(const EventTimerCore&) = delete;
+
+    Clock& clock() { return clock_; }
+    const Clock& clock() const { return clock_; }
+    Storage& storage() { return storage_; }
+    Dispatch& dispatch() { return dispatch_; }
+
+    /**
+     * @brief Get due times of scheduled events. Callers modifying the storage
+     *  outside the core keep the index up to date.
+     */
+    ScheduleIndex& schedule() { return schedule_; }
+    const ScheduleIndex& schedule() const { return schedule_; }
+
+    Counters& counters() { return counters_; }
+    const Counters& counters() const { return counters_; }
+
+    /**
+     * @brief Get lateness (dispatch time - due time, in milliseconds) of dispatched events.
+     */
+    const LatencyHistogram& lateness() const { return lateness_; }
+
+    /**
+     * @brief Set log message handler, or nullptr to disable logging.
+     */
+    void setLogger(Logger* logger) { logger_ = logger; }
+
+    /**
+     * @brief Set trace recorder, or nullptr to disable tracing.
+     */
+    void setTraceRecorder(TraceRecorder* recorder) { tracer_ = recorder; }
+
+    /**
+     * @brief Process events occured by now: collectExpired, updateExpired and notify.
+     * @param expired Batch for the occured events. Holds them after the call.
+     * @pre expired != nullptr.
+     */
+    void check(EventBatch* expired)
+    {
+        this->collectExpired(expired);
+        this->updateExpired(*expired);
+        this->notify(*expired);
+    }
+
+    /**
+     * @brief Get events due before the current time of the clock.
+     * @param expired Occured events are stored here with their due times decoded.
+     * @return True, if storage query succeeded. Error is logged otherwise.
+     * @pre expired != nullptr.
+     */
+    bool collectExpired(EventBatch* expired)
+    {
+        Q_ASSERT(expired != nullptr);
+        if (storage_.checkOccured(clock_.nowMsec(), expired)) return true;
+
+        this->logMessage(Logger::LEVEL_ERROR, [&]{ return "Could not check for events: " + storage_.errorString(); });
+        return false;
+    }
+
+    /**
+     * @brief Reschedule occured events, or remove them if their repeats have run out.
+     * @param expired Occured events with decoded due times.
+     * @post Storage and schedule index are updated. Events that could not be
+     *  rescheduled or removed are indexed RETRY_DELAY_MSEC from now, so that
+     *  the timer is armed to retry them.
+     */
+    void updateExpired(const EventBatch& expired)
+    {
+        if (expired.empty()) return;
+        TraceSpan span(tracer_, "EventTimerLogic::updateExpired");
+
+        order_.clear();
+        for (const Event& e : expired){
+            order_.push_back(&e);
+        }
+        std::sort(order_.begin(), order_.end(), scheduleLess);
+
+        // Events sharing timestamp, interval and repeats get the same new schedule,
+        // so it is computed and stored once per group.
+        qint64 now = clock_.nowMsec();
+        finished_.clear();
+        auto it = order_.begin();
+        while (it != order_.end()){
+            const Event* first = *it;
+            group_.clear();
+            for (; it != order_.end() && sameSchedule(first, *it); ++it){
+                group_.push_back((*it)->id());
+            }
+
+            qint64 next = 0;
+            unsigned repeatsLeft = 0;
+            qint64 due = expired.dueTime(unsigned(first - expired.begin()));
+            if (!nextOccurence(due, first->interval(), first->repeats(), now, &next, &repeatsLeft)){
+                // Repeat times have run out.
+                finished_.insert(finished_.end(), group_.begin(), group_.end());
+                continue;
+            }
+
+            if (storage_.rescheduleEvents(group_, next, first->interval(), repeatsLeft)){
+                counters_.eventsRescheduled.add(group_.size());
+                for (unsigned id : group_){
+                    schedule_.insert(id, next);
+                }
+            }
+            else {
+                // Rows stay expired in the storage. Expired index entries would keep the timer
+                // spinning, and dropping them would leave no timer to retry the events.
+                this->logMessage(Logger::LEVEL_ERROR, [&]{
+                    return "Could not reschedule " + QString::number(group_.size()) + " events: " +
+                            storage_.errorString();
+                });
+                this->retryLater(group_, now);
+            }
+        }
+
+        if (!finished_.empty()){
+            this->removeFinished(now);
+        }
+    }
+
+    /**
+     * @brief Dispatch occured events and record their lateness.
+     * @param expired Occured events with decoded due times.
+     */
+    void notify(const EventBatch& expired)
+    {
+        for (unsigned i = 0; i < expired.size(); ++i) {
+            lateness_.record(clock_.nowMsec() - expired.dueTime(i));
+            ScopedTimer handlerTimer(counters_.handlerTimeNsec);
+            TraceSpan notifySpan(tracer_, "EventHandler::notify");
+            dispatch_.notify(expired.at(i));
+            counters_.eventsFired.add();
+        }
+    }
+
+
+private:
+
+    Clock clock_;
+    Storage storage_;
+    Dispatch dispatch_;
+    ScheduleIndex schedule_;
+    Counters counters_;
+    LatencyHistogram lateness_;
+    Logger* logger_;
+    TraceRecorder* tracer_;
+
+    // Storage reused by every check, so steady-state ticks do not allocate containers.
+    std::vector<const Event*> order_;
+    std::vector<unsigned> group_;
+    std::vector<unsigned> finished_;
+
+
+    void removeFinished(qint64 now)
+    {
+        if (storage_.removeEvents(finished_)){
+            counters_.eventsRemoved.add(finished_.size());
+            for (unsigned id : finished_){
+                schedule_.remove(id);
+            }
+            this->logMessage(Logger::LEVEL_INFO, [&]{
+                return QString::number(finished_.size()) + " events removed.";
+            });
+        } else {
+            this->logMessage(Logger::LEVEL_ERROR, [&]{
+                return "Could not remove " + QString::number(finished_.size()) + " events: " +
+                        storage_.errorString() + ".";
+            });
+            this->retryLater(finished_, now);
+        }
+    }
+
+    // Index events to be checked again after RETRY_DELAY_MSEC.
+    void retryLater(const std::vector<unsigned>& eventIds, qint64 now)
+    {
+        for (unsigned id : eventIds){
+            schedule_.insert(id, now + RETRY_DELAY_MSEC);
+        }
+    }
+
+    // Log message created by calling format(). Message is formatted only if logger accepts the level.
+    template <typename Formatter>
+    void logMessage(Logger::Level level, Formatter format)
+    {
+        if (logger_ != nullptr && logger_->isEnabled(level)){
+            logger_->log(level, format());
+        }
+    }
+
+    // Find the first occurence at or after now of an event due at due. Returns false,
+    // if repeats run out before now. Otherwise sets next occurence time and repeats left.
+    static bool nextOccurence(qint64 due, unsigned interval, unsigned repeats, qint64 now,
+                              qint64* next, unsigned* repeatsLeft)
+    {
+        qint64 steps = 0;
+        if (due < now){
+            // Event without interval can not repeat, whatever its repeat count says.
+            if (repeats == 0 || interval == 0) return false;
+            steps = (now - due + interval - 1) / interval;
+        }
+        if (repeats != Event::INFINITE_REPEAT){
+            if (steps > qint64(repeats)) return false;
+            repeats -= unsigned(steps);
+        }
+        *next = due + steps * interval;
+        *repeatsLeft = repeats;
+        return true;
+    }
+
+    // Orders events so that events with identical schedule are adjacent.
+    static bool scheduleLess(const Event* a, const Event* b)
+    {
+        if (a->timestamp() != b->timestamp()) return a->timestamp() < b->timestamp();
+        if (a->interval() != b->interval()) return a->interval() < b->interval();
+        return a->repeats() < b->repeats();
+    }
+
+    static bool sameSchedule(const Event* a, const Event* b)
+    {
+        return a->timestamp() == b->timestamp() && a->interval() == b->interval() &&
+                a->repeats() == b->repeats();
+    }
+};
+
+} // namespace EventTimerNS
+
+#endif // EVENTTIMERCORE_HH
@@ -5,25 +5,70 @@
  */
 
 #include "eventtimerlogic.hh"
-#include <QDateTime>
+#include "timestamp.hh"
+#include "tracespan.hh"
+#include <QThread>
 
 
 namespace EventTimerNS
 {
 
+namespace
+{
+
+// Convert event timestamp to milliseconds since epoch.
+qint64 dueTime(const QString& timestamp)
+{
+    qint64 msecs = 0;
+    Timestamp::parse(timestamp, &msecs);
+    return msecs;
+}
+
+} // Anonymous namespace
+
+
+const qint64 EventTimerLogic::MAX_TIMER_INTERVAL_(24*60*60*1000);
+const qint64 EventTimerLogic::MAX_LATENCY_COMPENSATION_(10);
+
+
 EventTimerLogic::EventTimerLogic(std::unique_ptr<DatabaseHandler> dbHandler,
-                                 int refreshRate, QObject* parent) :
+                                 const TimerSetup& setup, QObject* parent) :
     QObject(parent), EventTimer(),
     dbHandler_(std::move(dbHandler)), eventHandler_(nullptr),
-    logger_(nullptr), refreshRate_(refreshRate), updateTimer_()
+    logger_(nullptr), tracer_(nullptr), refreshRate_(setup.refreshRate),
+    preciseTimer_(setup.preciseTimer), adaptiveRefresh_(setup.adaptiveRefresh),
+    coalesceSlack_(setup.coalesceSlack), running_(false), updateTimer_(),
+    core_(SystemClock(), SqlStorage(dbHandler_.get()), HandlerDispatch()),
+    scheduleLoaded_(false), publisher_(), expired_(), checking_(false),
+    checks_(), checkTimeNsec_(),
+    clock_(), deadline_(-1), wakeupTarget_(-1), latencyCompensation_(0)
 {
-    Q_ASSERT(refreshRate >= 0);
+    Q_ASSERT(setup.refreshRate >= 0);
+    Q_ASSERT(setup.coalesceSlack >= 0);
     Q_ASSERT(dbHandler_ != nullptr);
 
     connect(&updateTimer_, SIGNAL(timeout()), this, SLOT(checkEvents()) );
 
-    if (refreshRate_ != 0){
-        updateTimer_.setInterval(refreshRate);
+    if (preciseTimer_){
+        // Timer is re-armed towards a monotonic deadline after each timeout.
+        updateTimer_.setTimerType(Qt::PreciseTimer);
+        updateTimer_.setSingleShot(true);
+        clock_.start();
+    }
+    else if (adaptiveRefresh_){
+        updateTimer_.setSingleShot(true);
+    }
+    else if (refreshRate_ != 0){
+        updateTimer_.setInterval(refreshRate_);
+    }
+
+    if (!setup.scheduleViewKey.isEmpty()){
+        publisher_.reset(new SchedulePublisher(setup.scheduleViewKey, qMax(1u, setup.scheduleViewSize)));
+    }
+
+    if (dbHandler_->isValid()){
+        this->reloadSchedule();
+        this->publishSchedule();
     }
 }
 
@@ -39,29 +84,85 @@ unsigned EventTimerLogic::addEvent(Event* e)
     Q_ASSERT(e->isValid());
     Q_ASSERT(e->id() == Event::UNASSIGNED_ID);
 
+    qint64 previous = this->earliestDue();
     unsigned id = dbHandler_->addEvent(e);
     if (id == Event::UNASSIGNED_ID){
-        this->logMessage("Could not add event: " + this->errorString());
-    } else {
-        this->logMessage("Event added. Id = " + QString::number(id));
+        this->logMessage(Logger::LEVEL_ERROR, [&]{ return "Could not add event: " + this->errorString(); });
+        return id;
     }
 
-    if (refreshRate_ == 0 && updateTimer_.isActive()){
-        this->setTimerToNextEvent();
-    }
+    this->logMessage(Logger::LEVEL_INFO, [&]{ return "Event added. Id = " + QString::number(id); });
+    core_.schedule().insert(id, dueTime(e->timestamp()));
+    this->scheduleChanged(previous);
     return id;
 }
 
 
 bool EventTimerLogic::removeEvent(unsigned eventId)
 {
+    qint64 previous = this->earliestDue();
     bool rv = dbHandler_->removeEvent(eventId);
     if (rv) {
-        this->logMessage("Event removed (id = " + QString::number(eventId) + ").");
+        core_.counters().eventsRemoved.add();
+        core_.schedule().remove(eventId);
+        this->scheduleChanged(previous);
+        this->logMessage(Logger::LEVEL_INFO, [&]{
+            return "Event removed (id = " + QString::number(eventId) + ").";
+        });
     } else {
-        this->logMessage("Could not remove event (id = " +
-                         QString::number(eventId) + "): " +
-                         errorString() + ".");
+        this->logMessage(Logger::LEVEL_ERROR, [&]{
+            return "Could not remove event (id = " + QString::number(eventId) + "): " +
+                    errorString() + ".";
+        });
+    }
+
+    return rv;
+}
+
+
+bool EventTimerLogic::removeEvents(const std::vector<unsigned>& eventIds)
+{
+    qint64 previous = this->earliestDue();
+    unsigned removed = 0;
+    bool rv = dbHandler_->removeEvents(eventIds, &removed);
+    if (rv) {
+        core_.counters().eventsRemoved.add(removed);
+        for (unsigned id : eventIds){
+            core_.schedule().remove(id);
+        }
+        this->scheduleChanged(previous);
+        this->logMessage(Logger::LEVEL_INFO, [&]{
+            return QString::number(removed) + " events removed.";
+        });
+    } else {
+        this->logMessage(Logger::LEVEL_ERROR, [&]{
+            return "Could not remove " + QString::number(eventIds.size()) + " events: " +
+                    errorString() + ".";
+        });
+    }
+
+    return rv;
+}
+
+
+bool EventTimerLogic::rescheduleEvent(unsigned eventId, const QString& timestamp,
+                                      unsigned interval, unsigned repeats)
+{
+    Q_ASSERT(Timestamp::isValid(timestamp));
+
+    qint64 previous = this->earliestDue();
+    bool rv = dbHandler_->rescheduleEvent(eventId, timestamp, interval, repeats);
+    if (rv) {
+        core_.schedule().insert(eventId, dueTime(timestamp));
+        this->scheduleChanged(previous);
+        this->logMessage(Logger::LEVEL_INFO, [&]{
+            return "Event rescheduled (id = " + QString::number(eventId) + ") to " + timestamp + ".";
+        });
+    } else {
+        this->logMessage(Logger::LEVEL_ERROR, [&]{
+            return "Could not reschedule event (id = " + QString::number(eventId) + "): " +
+                    errorString();
+        });
     }
 
     return rv;
@@ -72,15 +173,17 @@ Event EventTimerLogic::getEvent(unsigned eventId)
 {
     Event e = dbHandler_->getEvent(eventId);
     if (e.id() == Event::UNASSIGNED_ID) {
-        if (this->errorString().isEmpty()){
-            logMessage("Could not get event (id=" +
-                       QString::number(eventId) + "): " +
-                       "No such event.");
+        if (dbHandler_->errorString().isEmpty()){
+            logMessage(Logger::LEVEL_WARNING, [&]{
+                return "Could not get event (id=" + QString::number(eventId) + "): " +
+                        "No such event.";
+            });
         }
         else {
-            logMessage("Could not get event (id=" +
-                       QString::number(eventId) + "): " +
-                       this->errorString() + ".");
+            logMessage(Logger::LEVEL_ERROR, [&]{
+                return "Could not get event (id=" + QString::number(eventId) + "): " +
+                        dbHandler_->errorString() + ".";
+            });
         }
     }
     return e;
@@ -91,23 +194,56 @@ std::vector<Event> EventTimerLogic::nextEvents(unsigned amount)
 {
     Q_ASSERT(amount != 0);
 
-    std::vector<Event> events = dbHandler_->nextEvents(QDateTime::currentDateTime().toString(Event::TIME_FORMAT), amount);
+    std::vector<Event> events = dbHandler_->nextEvents(Timestamp::now(), amount);
 
     if (events.size() == 0 && !dbHandler_->errorString().isEmpty()){
-        logMessage("Could not get next events: " + dbHandler_->errorString());
+        logMessage(Logger::LEVEL_ERROR, [&]{ return "Could not get next events: " + dbHandler_->errorString(); });
     }
 
     return events;
 }
 
 
+std::vector<Event> EventTimerLogic::eventsBetween(const QString& from, const QString& to,
+                                                  unsigned limit, const Event& after)
+{
+    Q_ASSERT(Timestamp::isValid(from));
+    Q_ASSERT(Timestamp::isValid(to));
+    Q_ASSERT(limit != 0);
+
+    bool firstPage = after.id() == Event::UNASSIGNED_ID;
+    std::vector<Event> events;
+    // Schedule index may only be used by the timer's own thread.
+    if (scheduleLoaded_ && QThread::currentThread() == this->thread()){
+        // Page through the in-memory index and fetch only the listed events.
+        std::vector<unsigned> ids = firstPage
+                ? core_.schedule().range(dueTime(from), dueTime(to), limit)
+                : core_.schedule().range(dueTime(from), dueTime(to), limit,
+                                         dueTime(after.timestamp()), after.id());
+        events = dbHandler_->getEvents(ids);
+    }
+    else {
+        events = dbHandler_->eventsBetween(from, to, limit,
+                                           firstPage ? QString() : after.timestamp(), after.id());
+    }
+
+    if (events.empty() && !dbHandler_->errorString().isEmpty()){
+        logMessage(Logger::LEVEL_ERROR, [&]{ return "Could not get events: " + dbHandler_->errorString(); });
+    }
+    return events;
+}
+
+
 bool EventTimerLogic::clearDynamic()
 {
+    qint64 previous = this->earliestDue();
     bool rv = dbHandler_->clearDynamic();
     if (rv) {
-        logMessage("Dynamic events cleared successfully.");
+        this->reloadSchedule();
+        this->scheduleChanged(previous);
+        logMessage(Logger::LEVEL_INFO, "Dynamic events cleared successfully.");
     } else {
-        logMessage("Dynamic events could not be cleared: " + errorString() + ".");
+        logMessage(Logger::LEVEL_ERROR, [&]{ return "Dynamic events could not be cleared: " + errorString() + "."; });
     }
     return rv;
 }
@@ -117,9 +253,46 @@ bool EventTimerLogic::clearAll()
 {
     bool rv = dbHandler_->clearAll();
     if (rv){
-        this->logMessage("All events cleared successfully");
+        // Table is empty, so the empty index is up to date.
+        core_.schedule().clear();
+        scheduleLoaded_ = true;
+        this->publishSchedule();
+        this->logMessage(Logger::LEVEL_INFO, "All events cleared successfully");
+    } else {
+        this->logMessage(Logger::LEVEL_ERROR, [&]{ return "Clearing events failed: " + this->errorString(); });
+    }
+    return rv;
+}
+
+
+bool EventTimerLogic::exportSnapshot(QIODevice* device)
+{
+    Q_ASSERT(device != nullptr);
+    Q_ASSERT(this->isValid());
+
+    bool rv = dbHandler_->exportSnapshot(device);
+    if (rv){
+        this->logMessage(Logger::LEVEL_INFO, "Snapshot exported successfully.");
     } else {
-        this->logMessage("Clearing events failed: " + this->errorString());
+        this->logMessage(Logger::LEVEL_ERROR, [&]{ return "Exporting snapshot failed: " + this->errorString(); });
+    }
+    return rv;
+}
+
+
+bool EventTimerLogic::importSnapshot(QIODevice* device)
+{
+    Q_ASSERT(device != nullptr);
+    Q_ASSERT(this->isValid());
+
+    qint64 previous = this->earliestDue();
+    bool rv = dbHandler_->importSnapshot(device);
+    if (rv){
+        this->reloadSchedule();
+        this->scheduleChanged(previous);
+        this->logMessage(Logger::LEVEL_INFO, "Snapshot imported successfully.");
+    } else {
+        this->logMessage(Logger::LEVEL_ERROR, [&]{ return "Importing snapshot failed: " + this->errorString(); });
     }
     return rv;
 }
@@ -129,24 +302,71 @@ void EventTimerLogic::setEventHandler(EventHandler* handler)
 {
     Q_ASSERT (handler != nullptr);
     eventHandler_ = handler;
+    core_.dispatch().setHandler(handler);
 }
 
 
 void EventTimerLogic::setLogger(Logger* logger)
 {
     logger_ = logger;
+    core_.setLogger(logger);
+}
+
+
+void EventTimerLogic::setTraceRecorder(TraceRecorder* recorder)
+{
+    tracer_ = recorder;
+    core_.setTraceRecorder(recorder);
+    dbHandler_->setTraceRecorder(recorder);
 }
 
 
 QString EventTimerLogic::errorString() const
 {
+    if (publisher_ != nullptr && !publisher_->isValid()){
+        return publisher_->errorString();
+    }
     return dbHandler_->errorString();
 }
 
 
 bool EventTimerLogic::isValid() const
 {
-    return dbHandler_->isValid();
+    return dbHandler_->isValid() && (publisher_ == nullptr || publisher_->isValid());
+}
+
+
+LatencyHistogram EventTimerLogic::firingLateness() const
+{
+    return core_.lateness();
+}
+
+
+EventTimer::Statistics EventTimerLogic::stats() const
+{
+    Q_ASSERT(this->isValid());
+
+    const DatabaseHandler::Statistics& dbStats = dbHandler_->statistics();
+    Statistics s;
+    s.insertStatements = dbStats.insertStatements.value();
+    s.deleteStatements = dbStats.deleteStatements.value();
+    s.updateStatements = dbStats.updateStatements.value();
+    s.selectStatements = dbStats.selectStatements.value();
+    s.rowsScanned = dbStats.rowsScanned.value();
+    s.databaseTimeNsec = dbStats.timeNsec.value();
+    const Core::Counters& counters = core_.counters();
+    s.handlerTimeNsec = counters.handlerTimeNsec.value();
+    s.eventsFired = counters.eventsFired.value();
+    s.eventsRescheduled = counters.eventsRescheduled.value();
+    s.eventsRemoved = counters.eventsRemoved.value();
+    // Counting rows would add to the statement counters read above.
+    bool indexed = scheduleLoaded_ && QThread::currentThread() == this->thread();
+    s.queueDepth = indexed ? core_.schedule().size() : dbHandler_->eventCount();
+    s.cacheHits = dbStats.cacheHits.value();
+    s.cacheMisses = dbStats.cacheMisses.value();
+    s.checks = checks_.value();
+    s.checkTimeNsec = checkTimeNsec_.value();
+    return s;
 }
 
 
@@ -154,109 +374,202 @@ void EventTimerLogic::start(CleanupPolicy policy)
 {
     Q_ASSERT(eventHandler_ != nullptr);
     Q_ASSERT(this->isValid());
-    Q_ASSERT(!updateTimer_.isActive());
+    Q_ASSERT(!running_);
 
     // Remove expired and dynamic events
     this->clearDynamic();
-    std::vector<Event> events = dbHandler_->checkOccured(QDateTime::currentDateTime().toString(Event::TIME_FORMAT));
-    for (Event e : events) {
-        this->updateExpired(e);
-        if (policy == NOTIFY){
+    EventBatch events;
+    core_.collectExpired(&events);
+    core_.updateExpired(events);
+    this->publishSchedule();
+    if (policy == NOTIFY){
+        for (const Event& e : events) {
             eventHandler_->notify(e);
         }
     }
 
-    if (refreshRate_ == 0){
-        this->setTimerToNextEvent();
-    } else {
+    running_ = true;
+    deadline_ = -1;
+    if (refreshRate_ != 0 && !preciseTimer_ && !adaptiveRefresh_){
         updateTimer_.start();
+    } else {
+        this->scheduleNextCheck();
     }
-    logMessage("Timer started.");
+    logMessage(Logger::LEVEL_INFO, "Timer started.");
 }
 
 
 void EventTimerLogic::stop()
 {
-    Q_ASSERT(updateTimer_.isActive());
+    Q_ASSERT(running_);
+    running_ = false;
     updateTimer_.stop();
 }
 
 
 void EventTimerLogic::checkEvents()
 {
-    // Get events from db.
-    std::vector<Event> expired = dbHandler_->checkOccured(QDateTime::currentDateTime().toString(Event::TIME_FORMAT));
-    if (expired.empty()){
-        if (!dbHandler_->errorString().isEmpty()){
-            this->logMessage("Could not check for events: " + this->errorString());
-        }
+    if (preciseTimer_ && this->rearmIfEarly()){
         return;
     }
+    ScopedTimer checkTimer(checkTimeNsec_);
+    TraceSpan span(tracer_, "EventTimerLogic::checkEvents");
+    checks_.add();
+
+    // Batch is reused between ticks. Handler may process events and re-enter
+    // checkEvents, so nested checks use a batch of their own.
+    EventBatch nested;
+    EventBatch& expired = checking_ ? nested : expired_;
+    bool outermost = !checking_;
+    checking_ = true;
+
+    // Get events from db, update or remove them and notify event handler.
+    core_.check(&expired);
+    if (outermost){
+        checking_ = false;
+        this->publishSchedule();
+    }
 
-    // Update or remove events.
-    for (Event e : expired) {
-        this->updateExpired(e);
+    // Handler may have stopped the timer.
+    if (running_){
+        this->scheduleNextCheck();
     }
+}
+
 
-    // Notify event handler.
-    for (Event e : expired) {
-        eventHandler_->notify(e);
+void EventTimerLogic::logMessage(Logger::Level level, const char* msg)
+{
+    if (logger_ != nullptr && logger_->isEnabled(level)){
+        logger_->log(level, QString::fromLatin1(msg));
     }
+}
 
-    if (refreshRate_ == 0){
+
+void EventTimerLogic::reloadSchedule()
+{
+    core_.schedule().clear();
+    std::vector<std::pair<unsigned, qint64> > dueTimes = dbHandler_->eventDueTimes();
+    scheduleLoaded_ = !dueTimes.empty() || dbHandler_->errorString().isEmpty();
+    if (!scheduleLoaded_){
+        this->logMessage(Logger::LEVEL_ERROR, [&]{ return "Could not load schedule: " + this->errorString(); });
+    }
+    for (const std::pair<unsigned, qint64>& entry : dueTimes){
+        core_.schedule().insert(entry.first, entry.second);
+    }
+}
+
+
+qint64 EventTimerLogic::earliestDue() const
+{
+    return core_.schedule().empty() ? Timestamp::INVALID_TIME : core_.schedule().earliest();
+}
+
+
+void EventTimerLogic::scheduleChanged(qint64 previousEarliest)
+{
+    this->publishSchedule();
+
+    // Polling modes notice changes on their next tick.
+    if (!running_ || (refreshRate_ != 0 && !adaptiveRefresh_)) return;
+
+    if (this->earliestDue() != previousEarliest){
         this->setTimerToNextEvent();
     }
 }
 
 
-void EventTimerLogic::logMessage(const QString& msg)
+void EventTimerLogic::publishSchedule()
 {
-    if (logger_ != nullptr){
-        logger_->logMsg(msg);
+    // Index that failed to load would be published as an empty schedule.
+    if (publisher_ != nullptr && publisher_->isValid() && !checking_ && scheduleLoaded_){
+        publisher_->publish(core_.schedule());
     }
 }
 
 
-bool EventTimerLogic::updateExpired(const Event& e)
+void EventTimerLogic::scheduleNextCheck()
 {
-    QDateTime current = QDateTime::currentDateTime();
-    unsigned repeats_left = e.repeats();
-    QDateTime nextTime = QDateTime::fromString(e.timestamp(), Event::TIME_FORMAT);
+    if (refreshRate_ == 0 || adaptiveRefresh_){
+        this->setTimerToNextEvent();
+    }
+    else if (preciseTimer_){
+        this->armNextPoll();
+    }
+}
 
-    // Find next occurence time after current time.
-    while (nextTime < current) {
-        if (repeats_left == 0) break;
-        nextTime = nextTime.addMSecs(e.interval());
-        if (repeats_left != Event::INFINITE_REPEAT){
-            repeats_left--;
-        }
+
+void EventTimerLogic::setTimerToNextEvent()
+{
+    // Adaptive timer polls at most refreshRate apart to notice events added by others.
+    qint64 diff = (adaptiveRefresh_ && refreshRate_ != 0) ? refreshRate_ : -1;
+
+    if (!core_.schedule().empty()){
+        // Coalesce deadlines within the slack window into a single tick.
+        qint64 tick = core_.schedule().latestWithin(coalesceSlack_);
+
+        // Event occurs once current time has passed its timestamp.
+        qint64 toTick = qMax(qint64(0), tick - core_.clock().nowMsec()) + 1;
+        diff = diff < 0 ? toTick : qMin(diff, toTick);
     }
+    if (diff < 0) return;
 
-    if (nextTime < current){
-        // Repeat times have run out.
-        this->removeEvent(e.id());
-        return true;
+    if (preciseTimer_){
+        deadline_ = clock_.elapsed() + diff;
     }
-    else {
-        // Update timestamp and repeats.
-        Event updated(e.name(), nextTime.toString(Event::TIME_FORMAT),
-                      e.type(), e.interval(), repeats_left);
-        dbHandler_->updateEvent(e.id(), updated);
+    this->armTimer(diff);
+}
+
+
+void EventTimerLogic::armTimer(qint64 delay)
+{
+    // Long waits are split. Timer is re-armed when it wakes up before the deadline.
+    delay = qMin(delay, MAX_TIMER_INTERVAL_);
+
+    if (preciseTimer_){
+        delay = qMax(qint64(0), delay - latencyCompensation_/8);
+        wakeupTarget_ = clock_.elapsed() + delay;
     }
-    return false;
+    updateTimer_.start(int(delay));
 }
 
 
-void EventTimerLogic::setTimerToNextEvent()
+void EventTimerLogic::armNextPoll()
 {
-    std::vector<Event> next = dbHandler_->nextEvents(QDateTime::currentDateTime().toString(Event::TIME_FORMAT), 1);
-    if (next.empty()) return;
+    qint64 now = clock_.elapsed();
+    if (deadline_ < 0){
+        deadline_ = now;
+    }
+    else if (deadline_ > now){
+        // Poll is still pending. Advancing the deadline would postpone it.
+        this->armTimer(deadline_ - now);
+        return;
+    }
 
-    QDateTime nextTime = QDateTime::fromString(next[0].timestamp(), Event::TIME_FORMAT);
-    int diff = QDateTime::currentDateTime().msecsTo(nextTime);
-    Q_ASSERT(diff >= 0);
+    // Keep polls on a fixed grid. Ticks missed while handling events are skipped.
+    do {
+        deadline_ += refreshRate_;
+    } while (deadline_ <= now);
+
+    this->armTimer(deadline_ - now);
+}
 
-    updateTimer_.start(diff);
+
+bool EventTimerLogic::rearmIfEarly()
+{
+    qint64 now = clock_.elapsed();
+
+    // Moving average of wake-up latency (scaled by 8) compensates timer drift.
+    if (wakeupTarget_ >= 0){
+        qint64 latency = qBound(qint64(0), now - wakeupTarget_, MAX_LATENCY_COMPENSATION_);
+        latencyCompensation_ += latency - latencyCompensation_/8;
+        wakeupTarget_ = -1;
+    }
+
+    if (now < deadline_){
+        this->armTimer(deadline_ - now);
+        return true;
+    }
+    return false;
 }
 
 } // namespace EventTimerNS
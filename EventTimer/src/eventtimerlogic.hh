@@ -9,9 +9,15 @@
 
 #include "eventtimer.hh"
 #include "databasehandler.hh"
+#include "counter.hh"
+#include "scheduleindex.hh"
+#include "schedulepublisher.hh"
+#include "eventtimercore.hh"
+#include "enginepolicies.hh"
 #include <memory>
 #include <QTimer>
 #include <QObject>
+#include <QElapsedTimer>
 
 namespace EventTimerNS
 {
@@ -25,14 +31,52 @@ class EventTimerLogic : public QObject, public EventTimer
 
 public:
 
+    /**
+     * @brief Timer setup parameters.
+     */
+    struct TimerSetup
+    {
+        /**
+         * @brief Event schedule refresh rate in milliseconds.
+         *  Value 0 sets timer directly to the next occuring event.
+         */
+        int refreshRate;
+
+        /**
+         * @brief Use Qt::PreciseTimer with monotonic deadlines and wake-up latency compensation.
+         */
+        bool preciseTimer;
+
+        /**
+         * @brief Sleep until the next known event, but at most refreshRate milliseconds.
+         */
+        bool adaptiveRefresh;
+
+        /**
+         * @brief Events occuring within this many milliseconds after the next event
+         *  are fired in the same tick (refreshRate == 0 or adaptive refresh only).
+         */
+        int coalesceSlack;
+
+        /**
+         * @brief Key of the shared-memory schedule view. Empty string disables publishing.
+         */
+        QString scheduleViewKey;
+
+        /**
+         * @brief Maximum number of upcoming events in the schedule view.
+         */
+        unsigned scheduleViewSize;
+    };
+
     /**
      * @brief Constructor.
      * @param dbHandler DatabaseHandler.
-     * @param refreshRate Event schedule refresh rate in milliseconds.
-     * @pre refreshRate >= 0.
+     * @param setup Timer setup parameters.
+     * @pre setup.refreshRate >= 0.
      */
     EventTimerLogic(std::unique_ptr<DatabaseHandler> dbHandler,
-                    int refreshRate, QObject* parent = 0);
+                    const TimerSetup& setup, QObject* parent = 0);
 
     /**
      * @brief Destructor.
@@ -42,14 +86,24 @@ public:
     // EventTimer interface
     virtual unsigned addEvent(Event* e);
     virtual bool removeEvent(unsigned eventId);
+    virtual bool removeEvents(const std::vector<unsigned>& eventIds);
+    virtual bool rescheduleEvent(unsigned eventId, const QString& timestamp,
+                                 unsigned interval, unsigned repeats);
     virtual Event getEvent(unsigned eventId);
     virtual std::vector<Event> nextEvents(unsigned amount);
+    virtual std::vector<Event> eventsBetween(const QString& from, const QString& to,
+                                             unsigned limit, const Event& after = Event());
     virtual bool clearDynamic();
     virtual bool clearAll();
+    virtual bool exportSnapshot(QIODevice* device);
+    virtual bool importSnapshot(QIODevice* device);
     virtual void setEventHandler(EventHandler* handler);
     virtual void setLogger(Logger* logger);
+    virtual void setTraceRecorder(TraceRecorder* recorder);
     virtual QString errorString() const;
     virtual bool isValid() const;
+    virtual LatencyHistogram firingLateness() const;
+    virtual Statistics stats() const;
     virtual void start(CleanupPolicy policy);
     virtual void stop();
 
@@ -67,14 +121,78 @@ private:
     std::unique_ptr<DatabaseHandler> dbHandler_;
     EventHandler* eventHandler_;
     Logger* logger_;
+    TraceRecorder* tracer_;
     int refreshRate_;
+    bool preciseTimer_;
+    bool adaptiveRefresh_;
+    qint64 coalesceSlack_;
+    bool running_;
     QTimer updateTimer_;
 
-    void logMessage(const QString& msg);
+    // Expiry processing with the Qt clock, SQL storage and EventHandler dispatch.
+    // Core's schedule index holds due times of events scheduled through this timer.
+    typedef EventTimerCore<SystemClock, SqlStorage, HandlerDispatch> Core;
+    Core core_;
+    bool scheduleLoaded_;
+    std::unique_ptr<SchedulePublisher> publisher_;
+
+    // Batch reused by every check, so steady-state ticks do not allocate containers.
+    EventBatch expired_;
+    bool checking_;
+
+    // Runtime statistics. Event counters are kept by the core.
+    Counter checks_;
+    Counter checkTimeNsec_;
+
+    // Precise mode state. All times are milliseconds on the monotonic clock_.
+    QElapsedTimer clock_;
+    qint64 deadline_;
+    qint64 wakeupTarget_;
+    qint64 latencyCompensation_; // Average wake-up latency scaled by 8.
+
+    static const qint64 MAX_TIMER_INTERVAL_;
+    static const qint64 MAX_LATENCY_COMPENSATION_;
+
+    // Log constant message, if logger accepts the level.
+    void logMessage(Logger::Level level, const char* msg);
 
-    bool updateExpired(const Event& e);
+    // Log message created by calling format(). Message is formatted only if logger accepts the level.
+    template <typename Formatter>
+    void logMessage(Logger::Level level, Formatter format)
+    {
+        if (logger_ != nullptr && logger_->isEnabled(level)){
+            logger_->log(level, format());
+        }
+    }
+
+    // Rebuild schedule index from the database.
+    void reloadSchedule();
+
+    // Earliest due time in schedule index, or Timestamp::INVALID_TIME if there are no events.
+    qint64 earliestDue() const;
+
+    // Re-arm timer if the earliest due time differs from previousEarliest.
+    // Publishes the schedule view.
+    void scheduleChanged(qint64 previousEarliest);
+
+    // Copy schedule into the shared-memory view, if enabled and the schedule is loaded.
+    // Changes made during a check are published once when the check ends.
+    void publishSchedule();
+
+    // Arm timer for the next check according to the refresh mode.
+    void scheduleNextCheck();
 
     void setTimerToNextEvent();
+
+    // Arm the timer to fire after delay milliseconds (precise mode compensates latency).
+    void armTimer(qint64 delay);
+
+    // Precise polling mode: arm timer to the next tick on the refresh rate grid.
+    // A pending tick is kept, so calling this again does not postpone the poll.
+    void armNextPoll();
+
+    // Precise mode: returns true if timer woke up before deadline and was re-armed.
+    bool rearmIfEarly();
 };
 
 } // namespace EventTimerNS
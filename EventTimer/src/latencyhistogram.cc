@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Implements the LatencyHistogram class defined in inc/latencyhistogram.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "latencyhistogram.hh"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+
+namespace EventTimerNS
+{
+
+namespace
+{
+
+// Values below 2^SUB_BUCKET_BITS are counted exactly. Above that, each power of two
+// is split into 2^(SUB_BUCKET_BITS-1) linear buckets.
+const int SUB_BUCKET_BITS = 7;
+const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+const int SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+const int MAX_VALUE_BITS = 32;
+const int BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+} // Anonymous namespace
+
+
+const qint64 LatencyHistogram::MAX_VALUE((Q_INT64_C(1) << MAX_VALUE_BITS) - 1);
+
+
+LatencyHistogram::LatencyHistogram() :
+    counts_(BUCKET_COUNT, 0), count_(0), min_(0), max_(0), sum_(0)
+{
+}
+
+
+void LatencyHistogram::record(qint64 value)
+{
+    value = qBound(qint64(0), value, MAX_VALUE);
+
+    ++counts_[bucketIndex(value)];
+    if (count_ == 0 || value < min_) min_ = value;
+    if (count_ == 0 || value > max_) max_ = value;
+    ++count_;
+    sum_ += value;
+}
+
+
+void LatencyHistogram::reset()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    min_ = 0;
+    max_ = 0;
+    sum_ = 0;
+}
+
+
+quint64 LatencyHistogram::count() const
+{
+    return count_;
+}
+
+
+qint64 LatencyHistogram::min() const
+{
+    return min_;
+}
+
+
+qint64 LatencyHistogram::max() const
+{
+    return max_;
+}
+
+
+double LatencyHistogram::mean() const
+{
+    return count_ == 0 ? 0 : sum_ / count_;
+}
+
+
+qint64 LatencyHistogram::percentile(double percentile) const
+{
+    Q_ASSERT(percentile >= 0 && percentile <= 100);
+
+    if (count_ == 0) return 0;
+    if (percentile <= 0) return min_;
+
+    quint64 target = quint64(std::ceil(percentile / 100 * count_));
+    target = qBound(quint64(1), target, count_);
+
+    quint64 seen = 0;
+    for (int i=0; i<BUCKET_COUNT; ++i){
+        seen += counts_[i];
+        if (seen >= target){
+            return qBound(min_, bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+
+int LatencyHistogram::bucketIndex(quint64 value)
+{
+    if (value < quint64(SUB_BUCKET_COUNT)){
+        return int(value);
+    }
+
+    // Shift value so that it falls into [SUB_BUCKET_HALF, SUB_BUCKET_COUNT).
+    int msb = 63 - int(qCountLeadingZeroBits(value));
+    int shift = msb - (SUB_BUCKET_BITS - 1);
+    int sub = int(value >> shift) - SUB_BUCKET_HALF;
+    return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF + sub;
+}
+
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < SUB_BUCKET_COUNT){
+        return index;
+    }
+
+    int k = index - SUB_BUCKET_COUNT;
+    int shift = k / SUB_BUCKET_HALF + 1;
+    qint64 sub = k % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+    return ((sub + 1) << shift) - 1;
+}
+
+} // namespace EventTimerNS
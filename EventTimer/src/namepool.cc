@@ -0,0 +1,48 @@
+/**
+ * @file
+ * @brief Implements the NamePool class defined in src/namepool.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "namepool.hh"
+#include <QMutexLocker>
+
+namespace EventTimerNS
+{
+
+NamePool::NamePool(unsigned capacity) :
+    mutex_(), capacity_(capacity), names_()
+{
+}
+
+
+QString NamePool::intern(const QString& name)
+{
+    if (capacity_ == 0) return name;
+
+    QMutexLocker lock(&mutex_);
+    QSet<QString>::const_iterator it = names_.constFind(name);
+    if (it != names_.constEnd()){
+        return *it;
+    }
+    if (unsigned(names_.size()) < capacity_){
+        names_.insert(name);
+    }
+    return name;
+}
+
+
+unsigned NamePool::size() const
+{
+    QMutexLocker lock(&mutex_);
+    return names_.size();
+}
+
+
+void NamePool::clear()
+{
+    QMutexLocker lock(&mutex_);
+    names_.clear();
+}
+
+} // namespace EventTimerNS
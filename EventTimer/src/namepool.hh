@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @brief Defines the NamePool class, a bounded interning table for event names.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef NAMEPOOL_HH
+#define NAMEPOOL_HH
+
+#include <QString>
+#include <QSet>
+#include <QMutex>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The NamePool class stores one shared copy of each distinct event name.
+ *  Names decoded from the database are replaced with the pooled copy, so events
+ *  with equal names share the same (implicitly shared) string data instead of
+ *  each holding its own. Pool holds up to capacity names. When the pool is full,
+ *  new names are passed through without interning. NamePool is thread-safe.
+ */
+class NamePool
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @param capacity Maximum number of pooled names. Capacity 0 disables interning.
+     * @post Pool is empty.
+     */
+    explicit NamePool(unsigned capacity);
+
+    NamePool(const NamePool&) = delete;
+    NamePool& operator=(const NamePool&) = delete;
+
+    /**
+     * @brief Get the pooled copy of a name.
+     * @param name Event name.
+     * @return String equal to @p name. If @p name is pooled, or there is room to add it,
+     *  returned string shares data with the pooled copy.
+     * @post Name is pooled, if pool was not full.
+     */
+    QString intern(const QString& name);
+
+    /**
+     * @brief Get number of pooled names.
+     * @return Number of pooled names.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Remove all names.
+     * @post Pool is empty. Strings returned earlier remain valid.
+     */
+    void clear();
+
+
+private:
+
+    mutable QMutex mutex_;
+    unsigned capacity_;
+    QSet<QString> names_;
+};
+
+} // namespace EventTimerNS
+
+#endif // NAMEPOOL_HH
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief Implements the ScheduleIndex class defined in src/scheduleindex.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "scheduleindex.hh"
+
+namespace EventTimerNS
+{
+
+ScheduleIndex::ScheduleIndex() :
+    queue_(), due_()
+{
+}
+
+
+void ScheduleIndex::insert(unsigned eventId, qint64 due)
+{
+    auto it = due_.find(eventId);
+    if (it != due_.end()){
+        if (it->second == due) return;
+        queue_.erase(std::make_pair(it->second, eventId));
+        it->second = due;
+    }
+    else {
+        due_.emplace(eventId, due);
+    }
+    queue_.insert(std::make_pair(due, eventId));
+}
+
+
+bool ScheduleIndex::remove(unsigned eventId)
+{
+    auto it = due_.find(eventId);
+    if (it == due_.end()) return false;
+
+    queue_.erase(std::make_pair(it->second, eventId));
+    due_.erase(it);
+    return true;
+}
+
+
+void ScheduleIndex::clear()
+{
+    queue_.clear();
+    due_.clear();
+}
+
+
+bool ScheduleIndex::empty() const
+{
+    return queue_.empty();
+}
+
+
+unsigned ScheduleIndex::size() const
+{
+    return queue_.size();
+}
+
+
+bool ScheduleIndex::contains(unsigned eventId) const
+{
+    return due_.find(eventId) != due_.end();
+}
+
+
+qint64 ScheduleIndex::earliest() const
+{
+    Q_ASSERT(!queue_.empty());
+    return queue_.begin()->first;
+}
+
+
+qint64 ScheduleIndex::latestWithin(qint64 window) const
+{
+    Q_ASSERT(!queue_.empty());
+    Q_ASSERT(window >= 0);
+
+    qint64 first = queue_.begin()->first;
+    if (window == 0) return first;
+
+    // Last entry before the first one past the window.
+    auto it = queue_.upper_bound(std::make_pair(first + window, unsigned(-1)));
+    --it;
+    return it->first;
+}
+
+std::vector<unsigned> ScheduleIndex::range(qint64 from, qint64 to, unsigned limit) const
+{
+    return this->collect(queue_.lower_bound(std::make_pair(from, 0u)), to, limit);
+}
+
+std::vector<unsigned> ScheduleIndex::range(qint64 from, qint64 to, unsigned limit,
+                                           qint64 afterDue, unsigned afterId) const
+{
+    // Continue after the previous page's last entry (keyset pagination).
+    auto it = queue_.lower_bound(std::make_pair(from, 0u));
+    auto cursor = queue_.upper_bound(std::make_pair(afterDue, afterId));
+    if (cursor == queue_.end() || (it != queue_.end() && *it < *cursor)){
+        it = cursor;
+    }
+    return this->collect(it, to, limit);
+}
+
+std::vector<unsigned> ScheduleIndex::collect(Queue::const_iterator it, qint64 to, unsigned limit) const
+{
+    std::vector<unsigned> ids;
+    for ( ; it != queue_.end() && it->first < to && ids.size() < limit; ++it){
+        ids.push_back(it->second);
+    }
+    return ids;
+}
+
+void ScheduleIndex::upcoming(unsigned limit, std::vector<std::pair<qint64, unsigned> >* entries) const
+{
+    Q_ASSERT(entries != nullptr);
+    entries->clear();
+    for (auto it = queue_.begin(); it != queue_.end() && entries->size() < limit; ++it){
+        entries->push_back(*it);
+    }
+}
+
+} // namespace EventTimerNS
@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief Defines the ScheduleIndex class, an in-memory due queue of scheduled events.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef SCHEDULEINDEX_HH
+#define SCHEDULEINDEX_HH
+
+#include <QtGlobal>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The ScheduleIndex class keeps event ids ordered by their due time.
+ *  Inserting, moving and removing an event takes O(log n) time, and the
+ *  earliest due time is available in constant time.
+ */
+class ScheduleIndex
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @post Index is empty.
+     */
+    ScheduleIndex();
+
+    /**
+     * @brief Add event into index, or move it if it is already indexed.
+     * @param eventId Event's id.
+     * @param due Event's due time (milliseconds since epoch).
+     * @post Event is indexed with due time @p due.
+     */
+    void insert(unsigned eventId, qint64 due);
+
+    /**
+     * @brief Remove event from index.
+     * @param eventId Event's id.
+     * @return True, if event was indexed.
+     * @post Event is not indexed.
+     */
+    bool remove(unsigned eventId);
+
+    /**
+     * @brief Remove all events from index.
+     * @post Index is empty.
+     */
+    void clear();
+
+    /**
+     * @brief Check if index is empty.
+     * @return True, if no events are indexed.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get number of indexed events.
+     * @return Number of indexed events.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Check if event is indexed.
+     * @param eventId Event's id.
+     * @return True, if event is indexed.
+     */
+    bool contains(unsigned eventId) const;
+
+    /**
+     * @brief Get the earliest due time.
+     * @return Due time of the next occuring event.
+     * @pre !empty().
+     */
+    qint64 earliest() const;
+
+    /**
+     * @brief Get the latest due time within a window starting from the earliest due time.
+     * @param window Window length in milliseconds.
+     * @return Largest indexed due time t such that t - earliest() <= @p window.
+     * @pre !empty(), window >= 0.
+     */
+    qint64 latestWithin(qint64 window) const;
+
+    /**
+     * @brief Get the first page of events due within a time range in (due time, id) order.
+     * @param from Start of the range (inclusive).
+     * @param to End of the range (exclusive).
+     * @param limit Maximum number of returned ids.
+     * @return Ids of up to @p limit earliest events due in [from, to).
+     */
+    std::vector<unsigned> range(qint64 from, qint64 to, unsigned limit) const;
+
+    /**
+     * @brief Get the next page of events due within a time range in (due time, id) order.
+     * @param from Start of the range (inclusive).
+     * @param to End of the range (exclusive).
+     * @param limit Maximum number of returned ids.
+     * @param afterDue Due time of the last event on the previous page. Any value is valid,
+     *  including negative due times before 1970.
+     * @param afterId Id of the last event on the previous page.
+     * @return Ids of up to @p limit events due in [from, to), ordered after (afterDue, afterId).
+     *  Takes O(log n + limit) time regardless of the page.
+     */
+    std::vector<unsigned> range(qint64 from, qint64 to, unsigned limit,
+                                qint64 afterDue, unsigned afterId) const;
+
+    /**
+     * @brief Get the next occuring events in (due time, id) order.
+     * @param limit Maximum number of events.
+     * @param entries (due time, id) pairs of up to @p limit earliest events are stored here.
+     *  Previous contents are cleared, but storage is reused.
+     * @pre entries != nullptr.
+     */
+    void upcoming(unsigned limit, std::vector<std::pair<qint64, unsigned> >* entries) const;
+
+
+private:
+
+    typedef std::set<std::pair<qint64, unsigned> > Queue;
+
+    // Collect up to limit ids due before to, starting at it.
+    std::vector<unsigned> collect(Queue::const_iterator it, qint64 to, unsigned limit) const;
+
+    Queue queue_;
+    std::unordered_map<unsigned, qint64> due_;
+};
+
+} // namespace EventTimerNS
+
+#endif // SCHEDULEINDEX_HH
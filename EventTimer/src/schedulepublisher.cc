@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @brief Implements the SchedulePublisher class defined in schedulepublisher.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "schedulepublisher.hh"
+#include <QDateTime>
+
+namespace EventTimerNS
+{
+
+SchedulePublisher::SchedulePublisher(const QString& key, unsigned capacity) :
+    memory_(key), capacity_(capacity), header_(nullptr), upcoming_(), errorString_()
+{
+    Q_ASSERT(!key.isEmpty());
+    Q_ASSERT(capacity > 0);
+
+    int size = int(sizeof(SharedScheduleHeader) + capacity * sizeof(SharedScheduleEntry));
+    if (!memory_.create(size)){
+        if (memory_.error() != QSharedMemory::AlreadyExists || !memory_.attach()){
+            errorString_ = "Could not create schedule view " + key + ": " + memory_.errorString();
+            return;
+        }
+        if (memory_.size() < size){
+            errorString_ = "Schedule view " + key + " is in use with a smaller capacity.";
+            memory_.detach();
+            return;
+        }
+    }
+    upcoming_.reserve(capacity);
+
+    // New segment is zero-filled. Reused segment may have been left in the middle of a write.
+    header_ = static_cast<SharedScheduleHeader*>(memory_.data());
+    if (header_->sequence.load(std::memory_order_relaxed) % 2 != 0){
+        header_->sequence.fetch_add(1, std::memory_order_release);
+    }
+    this->beginWrite();
+    header_->magic = SharedScheduleHeader::MAGIC;
+    header_->version = SharedScheduleHeader::VERSION;
+    header_->capacity = capacity;
+    header_->entryCount = 0;
+    header_->eventCount = 0;
+    header_->publishedMsec = QDateTime::currentMSecsSinceEpoch();
+    this->endWrite();
+}
+
+
+bool SchedulePublisher::isValid() const
+{
+    return header_ != nullptr;
+}
+
+
+QString SchedulePublisher::errorString() const
+{
+    return errorString_;
+}
+
+
+void SchedulePublisher::publish(const ScheduleIndex& schedule)
+{
+    Q_ASSERT(this->isValid());
+
+    // Entries are collected before the write begins to keep readers' retry window short.
+    schedule.upcoming(capacity_, &upcoming_);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    this->beginWrite();
+    SharedScheduleEntry* entries = sharedScheduleEntries(header_);
+    for (unsigned i = 0; i < upcoming_.size(); ++i){
+        entries[i].dueMsec = upcoming_[i].first;
+        entries[i].id = upcoming_[i].second;
+        entries[i].reserved = 0;
+    }
+    header_->entryCount = upcoming_.size();
+    header_->eventCount = schedule.size();
+    header_->publishedMsec = now;
+    this->endWrite();
+}
+
+
+void SchedulePublisher::beginWrite()
+{
+    header_->sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+
+void SchedulePublisher::endWrite()
+{
+    header_->sequence.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace EventTimerNS
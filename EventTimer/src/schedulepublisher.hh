@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Defines the SchedulePublisher class, which publishes the next occuring
+ *  events into shared memory for ScheduleView readers in other processes.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef SCHEDULEPUBLISHER_HH
+#define SCHEDULEPUBLISHER_HH
+
+#include <QSharedMemory>
+#include <QString>
+#include <vector>
+#include <utility>
+#include "scheduleindex.hh"
+#include "sharedschedule.hh"
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The SchedulePublisher class owns a shared-memory segment and copies the
+ *  earliest events of a ScheduleIndex into it. Publishing never waits for readers.
+ *  Only one thread may publish at a time.
+ */
+class SchedulePublisher
+{
+public:
+
+    /**
+     * @brief Constructor. Creates the shared-memory segment. Segment left behind by
+     *  a crashed process with the same key is reused.
+     * @param key Key of the segment (see QSharedMemory::setKey).
+     * @param capacity Maximum number of published events.
+     * @pre !key.isEmpty(), capacity > 0.
+     * @post If segment could not be created, publisher is invalid (see errorString).
+     *  Otherwise an empty schedule is published.
+     */
+    SchedulePublisher(const QString& key, unsigned capacity);
+
+    SchedulePublisher(const SchedulePublisher&) = delete;
+    SchedulePublisher& operator=(const SchedulePublisher&) = delete;
+
+    /**
+     * @brief Check if segment was created.
+     * @return True, if publisher is valid.
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Get error message.
+     * @return Message describing why segment could not be created.
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Publish event count and the earliest events of the schedule.
+     * @param schedule Published schedule.
+     * @pre Publisher is valid.
+     */
+    void publish(const ScheduleIndex& schedule);
+
+
+private:
+
+    QSharedMemory memory_;
+    unsigned capacity_;
+    SharedScheduleHeader* header_;
+    std::vector<std::pair<qint64, unsigned> > upcoming_;
+    QString errorString_;
+
+    // Make sequence odd. Readers retry until endWrite.
+    void beginWrite();
+    void endWrite();
+};
+
+} // namespace EventTimerNS
+
+#endif // SCHEDULEPUBLISHER_HH
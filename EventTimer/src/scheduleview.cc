@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Implements the ScheduleView class defined in inc/scheduleview.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "scheduleview.hh"
+#include "sharedschedule.hh"
+#include <QSharedMemory>
+#include <QThread>
+
+namespace EventTimerNS
+{
+
+ScheduleView::ScheduleView(const QString& key) :
+    memory_(new QSharedMemory(key)), errorString_()
+{
+    Q_ASSERT(!key.isEmpty());
+}
+
+
+ScheduleView::~ScheduleView()
+{
+}
+
+
+bool ScheduleView::attach()
+{
+    if (memory_->isAttached()) return true;
+
+    if (!memory_->attach(QSharedMemory::ReadOnly)){
+        errorString_ = "Could not attach to schedule view " + memory_->key() + ": " + memory_->errorString();
+        return false;
+    }
+    if (unsigned(memory_->size()) < sizeof(SharedScheduleHeader)){
+        errorString_ = "Shared memory " + memory_->key() + " is not a schedule view.";
+        memory_->detach();
+        return false;
+    }
+    errorString_.clear();
+    return true;
+}
+
+
+bool ScheduleView::isAttached() const
+{
+    return memory_->isAttached();
+}
+
+
+bool ScheduleView::read(State* state, unsigned maxRetries)
+{
+    Q_ASSERT(state != nullptr);
+    Q_ASSERT(this->isAttached());
+
+    const SharedScheduleHeader* header = static_cast<const SharedScheduleHeader*>(memory_->constData());
+    const SharedScheduleEntry* entries = sharedScheduleEntries(header);
+    unsigned maxEntries = (memory_->size() - sizeof(SharedScheduleHeader)) / sizeof(SharedScheduleEntry);
+
+    for (unsigned attempt = 0; attempt <= maxRetries; ++attempt){
+        quint32 begin = header->sequence.load(std::memory_order_acquire);
+        if (begin % 2 != 0){
+            QThread::yieldCurrentThread();
+            continue;
+        }
+
+        // Values may be torn by a concurrent write. They are validated only
+        // after the sequence check, and entryCount is bounded before copying.
+        quint32 magic = header->magic;
+        quint32 version = header->version;
+        unsigned count = qMin(header->entryCount, qMin(header->capacity, maxEntries));
+        state->generation = begin / 2;
+        state->eventCount = header->eventCount;
+        state->publishedMsec = header->publishedMsec;
+        state->upcoming.resize(count);
+        for (unsigned i = 0; i < count; ++i){
+            state->upcoming[i].id = entries[i].id;
+            state->upcoming[i].dueMsec = entries[i].dueMsec;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header->sequence.load(std::memory_order_relaxed) != begin) continue;
+
+        if (magic != SharedScheduleHeader::MAGIC || version != SharedScheduleHeader::VERSION){
+            errorString_ = "Shared memory " + memory_->key() + " is not a schedule view of this version.";
+            return false;
+        }
+        errorString_.clear();
+        return true;
+    }
+
+    errorString_ = "Schedule view was updated during every read attempt.";
+    return false;
+}
+
+
+QString ScheduleView::errorString() const
+{
+    return errorString_;
+}
+
+} // namespace EventTimerNS
@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @brief Defines the layout of the shared-memory schedule view written by
+ *  SchedulePublisher and read by ScheduleView.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef SHAREDSCHEDULE_HH
+#define SHAREDSCHEDULE_HH
+
+#include <QtGlobal>
+#include <atomic>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief Header of the shared-memory segment. Header is followed by
+ *  capacity SharedScheduleEntry structs.
+ *  Segment is updated with a seqlock: writer makes sequence odd before
+ *  modifying the segment and even again afterwards. Reader copies the segment
+ *  and accepts the copy only if sequence was even and unchanged meanwhile,
+ *  so readers never block the writer.
+ */
+struct SharedScheduleHeader
+{
+    static const quint32 MAGIC = 0x45545356; // "ETSV"
+    static const quint32 VERSION = 1;
+
+    std::atomic<quint32> sequence;
+    quint32 magic;
+    quint32 version;
+    quint32 capacity;
+    quint32 entryCount;
+    quint32 eventCount;
+    qint64 publishedMsec;
+};
+
+
+/**
+ * @brief Next occuring event.
+ */
+struct SharedScheduleEntry
+{
+    qint64 dueMsec;
+    quint32 id;
+    quint32 reserved;
+};
+
+
+// Segment is shared between processes, so the atomic must be a plain lock-free integer.
+static_assert(sizeof(std::atomic<quint32>) == sizeof(quint32),
+              "std::atomic<quint32> must have the size of quint32.");
+
+
+/**
+ * @brief Get the entry array following the header.
+ */
+inline SharedScheduleEntry* sharedScheduleEntries(SharedScheduleHeader* header)
+{
+    return reinterpret_cast<SharedScheduleEntry*>(header + 1);
+}
+
+inline const SharedScheduleEntry* sharedScheduleEntries(const SharedScheduleHeader* header)
+{
+    return reinterpret_cast<const SharedScheduleEntry*>(header + 1);
+}
+
+} // namespace EventTimerNS
+
+#endif // SHAREDSCHEDULE_HH
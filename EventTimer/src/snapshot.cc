@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @brief Implements the SnapshotWriter and SnapshotReader classes defined in snapshot.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "snapshot.hh"
+#include "timestamp.hh"
+#include <QIODevice>
+
+namespace
+{
+
+// Due times of the years 1000-9999 (UTC). Timestamp formatting overflows far outside this range.
+const qint64 MIN_DUE_MSEC = Q_INT64_C(-30610224000000);
+const qint64 MAX_DUE_MSEC = Q_INT64_C(253402300800000);
+
+} // Anonymous namespace
+
+
+namespace EventTimerNS
+{
+
+const quint32 Snapshot::MAGIC = 0x4554534E; // "ETSN"
+const quint16 Snapshot::VERSION = 1;
+
+
+SnapshotWriter::SnapshotWriter(QIODevice* device) :
+    out_(device), names_(), count_(0), errorString_()
+{
+    Q_ASSERT(device != nullptr);
+    Q_ASSERT(device->isWritable());
+
+    out_.setVersion(QDataStream::Qt_5_0);
+    out_ << Snapshot::MAGIC << Snapshot::VERSION;
+}
+
+
+bool SnapshotWriter::write(const Event& e)
+{
+    Q_ASSERT(e.isValid());
+    Q_ASSERT(e.id() != Event::UNASSIGNED_ID);
+
+    qint64 due;
+    if (!Timestamp::parse(e.timestamp(), &due)){
+        errorString_ = "Invalid timestamp " + e.timestamp() + " in event " + QString::number(e.id());
+        return false;
+    }
+
+    // Each distinct name is written once and referred by its number.
+    auto it = names_.find(e.name());
+    if (it == names_.end()){
+        it = names_.insert(e.name(), names_.size());
+        out_ << quint8(Snapshot::NAME) << e.name();
+    }
+
+    out_ << quint8(Snapshot::EVENT) << quint32(e.id()) << it.value() << due
+         << quint32(e.interval()) << quint32(e.repeats())
+         << quint8(e.type() == Event::STATIC ? 1 : 0);
+    ++count_;
+    return this->checkStatus();
+}
+
+
+bool SnapshotWriter::finish()
+{
+    out_ << quint8(Snapshot::END) << count_;
+    return this->checkStatus();
+}
+
+
+QString SnapshotWriter::errorString() const
+{
+    return errorString_;
+}
+
+
+bool SnapshotWriter::checkStatus()
+{
+    if (out_.status() != QDataStream::Ok){
+        errorString_ = "Could not write snapshot: " + out_.device()->errorString();
+        return false;
+    }
+    return true;
+}
+
+
+SnapshotReader::SnapshotReader(QIODevice* device) :
+    in_(device), names_(), count_(0), end_(false), errorString_()
+{
+    Q_ASSERT(device != nullptr);
+    Q_ASSERT(device->isReadable());
+
+    in_.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in_ >> magic >> version;
+
+    if (in_.status() != QDataStream::Ok || magic != Snapshot::MAGIC){
+        this->fail("Not an EventTimer snapshot.");
+    } else if (version > Snapshot::VERSION){
+        this->fail("Unsupported snapshot version " + QString::number(version) + ".");
+    }
+}
+
+
+bool SnapshotReader::read(Event* e)
+{
+    Q_ASSERT(e != nullptr);
+
+    while (!end_ && errorString_.isEmpty()){
+        quint8 tag = Snapshot::END;
+        in_ >> tag;
+        if (in_.status() != QDataStream::Ok) return this->fail("Snapshot is truncated.");
+
+        if (tag == Snapshot::NAME){
+            QString name;
+            in_ >> name;
+            names_.append(name);
+        }
+        else if (tag == Snapshot::EVENT){
+            quint32 id, name, interval, repeats;
+            qint64 due;
+            quint8 type;
+            in_ >> id >> name >> due >> interval >> repeats >> type;
+            if (in_.status() != QDataStream::Ok) return this->fail("Snapshot is truncated.");
+            if (name >= unsigned(names_.size()) || type > 1 || id == Event::UNASSIGNED_ID ||
+                    due < MIN_DUE_MSEC || due >= MAX_DUE_MSEC){
+                return this->fail("Corrupted event record in snapshot.");
+            }
+
+            e->setId(id);
+            e->setName(names_.at(name));
+            e->setTimestamp(Timestamp::format(due));
+            e->setInterval(interval);
+            e->setRepeats(repeats);
+            e->setType(type == 1 ? Event::STATIC : Event::DYNAMIC);
+            if (!e->isValid()) return this->fail("Invalid event " + QString::number(id) + " in snapshot.");
+            ++count_;
+            return true;
+        }
+        else if (tag == Snapshot::END){
+            quint32 count = 0;
+            in_ >> count;
+            if (in_.status() != QDataStream::Ok) return this->fail("Snapshot is truncated.");
+            if (count != count_) return this->fail("Snapshot event count does not match.");
+            end_ = true;
+        }
+        else {
+            return this->fail("Unknown record in snapshot.");
+        }
+
+        if (in_.status() != QDataStream::Ok) return this->fail("Snapshot is truncated.");
+    }
+    return false;
+}
+
+
+bool SnapshotReader::isValid() const
+{
+    return errorString_.isEmpty();
+}
+
+
+bool SnapshotReader::atEnd() const
+{
+    return end_;
+}
+
+
+QString SnapshotReader::errorString() const
+{
+    return errorString_;
+}
+
+
+bool SnapshotReader::fail(const QString& error)
+{
+    errorString_ = error;
+    return false;
+}
+
+} // namespace EventTimerNS
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @brief Defines the SnapshotWriter and SnapshotReader classes, that encode
+ *  and decode the binary schedule snapshot format.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef SNAPSHOT_HH
+#define SNAPSHOT_HH
+
+#include <QDataStream>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include "event.hh"
+
+class QIODevice;
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief Constants of the snapshot format.
+ *  Snapshot starts with a header (magic number, format version) followed by
+ *  records. Each record starts with a tag byte:
+ *   - NAME: event name (QString). Names are numbered in order of appearance.
+ *   - EVENT: id, name number, due time (milliseconds since epoch, UTC), interval,
+ *     repeats and type of an event.
+ *   - END: number of EVENT records in the snapshot.
+ *  Events are written in (timestamp, id) order. All values use QDataStream
+ *  encoding of Qt 5.0 (big endian).
+ */
+struct Snapshot
+{
+    static const quint32 MAGIC;
+    static const quint16 VERSION;
+
+    enum Tag {
+        END = 0,
+        NAME = 1,
+        EVENT = 2
+    };
+};
+
+
+/**
+ * @brief The SnapshotWriter class encodes events into a snapshot.
+ */
+class SnapshotWriter
+{
+public:
+
+    /**
+     * @brief Constructor. Writes the snapshot header.
+     * @param device Output device.
+     * @pre device != nullptr and is open for writing.
+     */
+    explicit SnapshotWriter(QIODevice* device);
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    /**
+     * @brief Write event into the snapshot.
+     * @param e Written event.
+     * @return True, if event was written. Otherwise errorString() describes the error.
+     * @pre e is valid and has an assigned id. finish has not been called.
+     */
+    bool write(const Event& e);
+
+    /**
+     * @brief Write the end record.
+     * @return True, if snapshot was written successfully.
+     *  Otherwise errorString() describes the error.
+     */
+    bool finish();
+
+    /**
+     * @brief Get error message.
+     * @return Message describing the latest error.
+     */
+    QString errorString() const;
+
+
+private:
+
+    QDataStream out_;
+    QHash<QString, quint32> names_;
+    quint32 count_;
+    QString errorString_;
+
+    bool checkStatus();
+};
+
+
+/**
+ * @brief The SnapshotReader class decodes events from a snapshot.
+ */
+class SnapshotReader
+{
+public:
+
+    /**
+     * @brief Constructor. Reads and validates the snapshot header.
+     * @param device Input device.
+     * @pre device != nullptr and is open for reading.
+     * @post If header is not valid, reader becomes invalid (see errorString).
+     */
+    explicit SnapshotReader(QIODevice* device);
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    /**
+     * @brief Read next event.
+     * @param e Read event is stored here. Timestamp is formatted in local time.
+     * @return True, if an event was read. Returns false at the end of the
+     *  snapshot, or if snapshot is corrupted (errorString is not empty).
+     * @pre e != nullptr.
+     */
+    bool read(Event* e);
+
+    /**
+     * @brief Check if snapshot has been decoded without errors.
+     * @return True, if no errors have occured.
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Check if the end record has been read.
+     * @return True, if all events of the snapshot have been read.
+     */
+    bool atEnd() const;
+
+    /**
+     * @brief Get error message.
+     * @return Message describing the error, or empty string if there are no errors.
+     */
+    QString errorString() const;
+
+
+private:
+
+    QDataStream in_;
+    QStringList names_;
+    quint32 count_;
+    bool end_;
+    QString errorString_;
+
+    bool fail(const QString& error);
+};
+
+} // namespace EventTimerNS
+
+#endif // SNAPSHOT_HH
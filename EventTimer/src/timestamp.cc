@@ -0,0 +1,343 @@
+/**
+ * @file
+ * @brief Implements the Timestamp class defined in src/timestamp.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "timestamp.hh"
+#include "event.hh"
+#include <QDateTime>
+#include <atomic>
+#include <limits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace EventTimerNS
+{
+
+namespace
+{
+
+const qint64 MSECS_PER_DAY = 86400000;
+
+// Julian day of 1970-01-01.
+const qint64 EPOCH_JULIAN_DAY = 2440588;
+
+// Years converted without QDateTime. QDateTime pads shorter years differently.
+const int MIN_FAST_YEAR = 1000;
+const int MAX_FAST_YEAR = 9999;
+
+// Cached UTC offsets in direct-mapped tables indexed by day. High 32 bits of
+// an entry hold the day (sign bit flipped, so that zero means empty), low 32
+// bits hold the offset in seconds.
+const unsigned CACHE_SIZE = 64;
+const quint32 DAY_BIAS = 0x80000000u;
+std::atomic<quint64> localDayOffsets[CACHE_SIZE];  // Keyed by local day.
+std::atomic<quint64> utcDayOffsets[CACHE_SIZE];    // Keyed by UTC day.
+
+
+qint64 floorDiv(qint64 a, qint64 b)
+{
+    return a / b - (a % b < 0 ? 1 : 0);
+}
+
+
+// Days since epoch of a civil date (proleptic Gregorian calendar).
+qint64 daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2 ? 1 : 0;
+    qint64 era = floorDiv(year, 400);
+    qint64 yearOfEra = year - era * 400;
+    qint64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    qint64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+
+// Civil date of days since epoch.
+void civilFromDays(qint64 days, int* year, int* month, int* day)
+{
+    days += 719468;
+    qint64 era = floorDiv(days, 146097);
+    qint64 dayOfEra = days - era * 146097;
+    qint64 yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    qint64 dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    qint64 mp = (5 * dayOfYear + 2) / 153;
+    *day = int(dayOfYear - (153 * mp + 2) / 5 + 1);
+    *month = int(mp < 10 ? mp + 3 : mp - 9);
+    *year = int(yearOfEra + era * 400 + (*month <= 2 ? 1 : 0));
+}
+
+
+int daysInMonth(int year, int month)
+{
+    static const int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)){
+        return 29;
+    }
+    return DAYS[month - 1];
+}
+
+
+// Look up cached offset for day. Computes offsets at both ends of the day
+// on cache miss, and returns false if they differ (day contains a transition).
+bool cachedOffset(std::atomic<quint64>* cache, qint64 day, int* offset,
+                  int (*offsetAt)(qint64 day))
+{
+    quint64 key = quint64(quint32(day) ^ DAY_BIAS) << 32;
+    std::atomic<quint64>& slot = cache[quint32(day) % CACHE_SIZE];
+    quint64 entry = slot.load(std::memory_order_relaxed);
+    if ((entry & 0xFFFFFFFF00000000ull) == key){
+        *offset = qint32(quint32(entry));
+        return true;
+    }
+
+    int start = offsetAt(day);
+    if (start != offsetAt(day + 1)){
+        return false;
+    }
+    slot.store(key | quint32(start), std::memory_order_relaxed);
+    *offset = start;
+    return true;
+}
+
+
+// UTC offset at local midnight starting the local day.
+int offsetAtLocalDay(qint64 day)
+{
+    return QDateTime(QDate::fromJulianDay(day + EPOCH_JULIAN_DAY), QTime(0, 0)).offsetFromUtc();
+}
+
+
+// UTC offset at UTC midnight starting the UTC day.
+int offsetAtUtcDay(qint64 day)
+{
+    return QDateTime::fromMSecsSinceEpoch(day * MSECS_PER_DAY).offsetFromUtc();
+}
+
+
+// Timestamp fields.
+struct Fields
+{
+    int year, month, day, hour, minute, second, msec;
+};
+
+
+// Read count decimal digits starting at pos. Returns -1, if any character is not a digit.
+int digits(const QChar* data, int pos, int count)
+{
+    int value = 0;
+    for (int i = pos; i < pos + count; ++i){
+        unsigned digit = data[i].unicode() - '0';
+        if (digit > 9) return -1;
+        value = value * 10 + int(digit);
+    }
+    return value;
+}
+
+
+void writeDigits(QChar* data, int pos, int count, int value)
+{
+    for (int i = pos + count - 1; i >= pos; --i){
+        data[i] = QChar('0' + value % 10);
+        value /= 10;
+    }
+}
+
+
+// Check field ranges.
+bool validFields(const Fields& f)
+{
+    return f.year >= 0 && f.month >= 1 && f.month <= 12 && f.day >= 1 &&
+            f.day <= daysInMonth(f.year, f.month) && f.hour >= 0 && f.hour <= 23 &&
+            f.minute >= 0 && f.minute <= 59 && f.second >= 0 && f.second <= 59 && f.msec >= 0;
+}
+
+
+// Split timestamp of Timestamp::LENGTH characters into fields, one character at a time.
+bool decodeScalar(const QChar* d, Fields* f)
+{
+    if (d[4] != '-' || d[7] != '-' || d[10] != ' ' || d[13] != ':' || d[16] != ':' || d[19] != ':'){
+        return false;
+    }
+    f->year = digits(d, 0, 4);
+    f->month = digits(d, 5, 2);
+    f->day = digits(d, 8, 2);
+    f->hour = digits(d, 11, 2);
+    f->minute = digits(d, 14, 2);
+    f->second = digits(d, 17, 2);
+    f->msec = digits(d, 20, 3);
+    return validFields(*f);
+}
+
+
+#ifdef __SSE2__
+// Split timestamp of Timestamp::LENGTH characters into fields. All characters are
+// checked at once: UTF-16 code units are narrowed to bytes (anything outside
+// Latin-1 saturates to a non-digit), and digit and separator positions are
+// compared against the format in two 16 byte vectors. Second vector starts at
+// character 15, so that no more than LENGTH characters are read.
+bool decodeSse2(const QChar* d, Fields* f)
+{
+    const __m128i* p = reinterpret_cast<const __m128i*>(d);
+    __m128i low = _mm_packus_epi16(_mm_loadu_si128(p), _mm_loadu_si128(p + 1));
+    __m128i high = _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(d + 15)),
+                                    _mm_setzero_si128());
+
+    // Separators and their positions, characters 0-15 and 15-22.
+    const __m128i lowSeparators = _mm_setr_epi8(0, 0, 0, 0, '-', 0, 0, '-', 0, 0, ' ', 0, 0, ':', 0, 0);
+    const __m128i lowSeparatorMask = _mm_setr_epi8(0, 0, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0);
+    const __m128i highSeparators = _mm_setr_epi8(0, ':', 0, 0, ':', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i highSeparatorMask = _mm_setr_epi8(0, -1, 0, 0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+
+    __m128i lowDigits = _mm_sub_epi8(low, zero);
+    __m128i highDigits = _mm_sub_epi8(high, zero);
+    __m128i lowOk = _mm_or_si128(
+                _mm_andnot_si128(lowSeparatorMask, _mm_cmpeq_epi8(_mm_max_epu8(lowDigits, nine), nine)),
+                _mm_and_si128(lowSeparatorMask, _mm_cmpeq_epi8(low, lowSeparators)));
+    __m128i highOk = _mm_or_si128(
+                _mm_andnot_si128(highSeparatorMask, _mm_cmpeq_epi8(_mm_max_epu8(highDigits, nine), nine)),
+                _mm_and_si128(highSeparatorMask, _mm_cmpeq_epi8(high, highSeparators)));
+    if (_mm_movemask_epi8(lowOk) != 0xFFFF || (_mm_movemask_epi8(highOk) & 0xFF) != 0xFF){
+        return false;
+    }
+
+    alignas(16) quint8 a[16];
+    alignas(16) quint8 b[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(a), lowDigits);
+    _mm_store_si128(reinterpret_cast<__m128i*>(b), highDigits);
+    f->year = a[0] * 1000 + a[1] * 100 + a[2] * 10 + a[3];
+    f->month = a[5] * 10 + a[6];
+    f->day = a[8] * 10 + a[9];
+    f->hour = a[11] * 10 + a[12];
+    f->minute = a[14] * 10 + a[15];
+    f->second = b[2] * 10 + b[3];
+    f->msec = b[5] * 100 + b[6] * 10 + b[7];
+    return validFields(*f);
+}
+#endif
+
+
+// Convert valid fields into milliseconds since epoch.
+bool toMSecs(const Fields& f, const QString& timestamp, qint64* msecs)
+{
+    qint64 localDay = daysFromCivil(f.year, f.month, f.day);
+    qint64 msecOfDay = ((f.hour * 60 + f.minute) * 60 + f.second) * 1000 + f.msec;
+    int offset;
+    if (f.year < MIN_FAST_YEAR || !cachedOffset(localDayOffsets, localDay, &offset, offsetAtLocalDay)){
+        // Unusual year or daylight saving transition (times may be skipped or repeated).
+        QDateTime dt = QDateTime::fromString(timestamp, Event::TIME_FORMAT);
+        if (!dt.isValid()) return false;
+        *msecs = dt.toMSecsSinceEpoch();
+        return true;
+    }
+    *msecs = localDay * MSECS_PER_DAY + msecOfDay - qint64(offset) * 1000;
+    return true;
+}
+
+} // Anonymous namespace
+
+
+const qint64 Timestamp::INVALID_TIME = std::numeric_limits<qint64>::min();
+
+
+bool Timestamp::parse(const QString& timestamp, qint64* msecs)
+{
+    Q_ASSERT(msecs != nullptr);
+    Fields f;
+    return timestamp.size() == LENGTH && decodeScalar(timestamp.constData(), &f) &&
+            toMSecs(f, timestamp, msecs);
+}
+
+
+unsigned Timestamp::parseBatch(const QString* timestamps, unsigned count, qint64* msecs, bool allowSimd)
+{
+    Q_ASSERT(count == 0 || (timestamps != nullptr && msecs != nullptr));
+#ifdef __SSE2__
+    bool (*decode)(const QChar*, Fields*) = allowSimd ? decodeSse2 : decodeScalar;
+#else
+    Q_UNUSED(allowSimd);
+    bool (*decode)(const QChar*, Fields*) = decodeScalar;
+#endif
+
+    unsigned invalid = 0;
+    for (unsigned i = 0; i < count; ++i){
+        const QString& timestamp = timestamps[i];
+        if (i != 0 && timestamp == timestamps[i-1]){
+            // Result sets are usually ordered by timestamp, so repeats are common.
+            msecs[i] = msecs[i-1];
+        }
+        else {
+            Fields f;
+            if (timestamp.size() != LENGTH || !decode(timestamp.constData(), &f) ||
+                    !toMSecs(f, timestamp, &msecs[i])){
+                msecs[i] = INVALID_TIME;
+            }
+        }
+        if (msecs[i] == INVALID_TIME) ++invalid;
+    }
+    return invalid;
+}
+
+
+bool Timestamp::simdAvailable()
+{
+#ifdef __SSE2__
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+bool Timestamp::isValid(const QString& timestamp)
+{
+    qint64 msecs;
+    return parse(timestamp, &msecs);
+}
+
+
+QString Timestamp::format(qint64 msecs)
+{
+    int offset;
+    if (!cachedOffset(utcDayOffsets, floorDiv(msecs, MSECS_PER_DAY), &offset, offsetAtUtcDay)){
+        return QDateTime::fromMSecsSinceEpoch(msecs).toString(Event::TIME_FORMAT);
+    }
+
+    qint64 local = msecs + qint64(offset) * 1000;
+    qint64 day = floorDiv(local, MSECS_PER_DAY);
+    int msecOfDay = int(local - day * MSECS_PER_DAY);
+    int year, month, dayOfMonth;
+    civilFromDays(day, &year, &month, &dayOfMonth);
+    if (year < MIN_FAST_YEAR || year > MAX_FAST_YEAR){
+        return QDateTime::fromMSecsSinceEpoch(msecs).toString(Event::TIME_FORMAT);
+    }
+
+    QString timestamp(LENGTH, Qt::Uninitialized);
+    QChar* d = timestamp.data();
+    writeDigits(d, 0, 4, year);
+    d[4] = '-';
+    writeDigits(d, 5, 2, month);
+    d[7] = '-';
+    writeDigits(d, 8, 2, dayOfMonth);
+    d[10] = ' ';
+    writeDigits(d, 11, 2, msecOfDay / 3600000);
+    d[13] = ':';
+    writeDigits(d, 14, 2, msecOfDay / 60000 % 60);
+    d[16] = ':';
+    writeDigits(d, 17, 2, msecOfDay / 1000 % 60);
+    d[19] = ':';
+    writeDigits(d, 20, 3, msecOfDay % 1000);
+    return timestamp;
+}
+
+
+QString Timestamp::now()
+{
+    return format(QDateTime::currentMSecsSinceEpoch());
+}
+
+} // namespace EventTimerNS
@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @brief Defines the Timestamp class, a fast parser and formatter for
+ *  timestamps in Event::TIME_FORMAT.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef TIMESTAMP_HH
+#define TIMESTAMP_HH
+
+#include <QString>
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief The Timestamp class converts between Event::TIME_FORMAT timestamps
+ *  (local time) and milliseconds since epoch. Conversions give the same results
+ *  as QDateTime::fromString and QDateTime::toString with Event::TIME_FORMAT,
+ *  but the fixed format is handled directly instead of interpreting the pattern.
+ *  UTC offsets are cached per day, and days containing a daylight saving
+ *  transition are converted with QDateTime. Changes of the system time zone
+ *  while the process runs are not noticed. All functions are thread-safe.
+ */
+class Timestamp
+{
+public:
+
+    Timestamp() = delete;
+
+    /**
+     * @brief Length of a timestamp in Event::TIME_FORMAT.
+     */
+    static const int LENGTH = 23;
+
+    /**
+     * @brief Time stored by parseBatch for invalid timestamps.
+     */
+    static const qint64 INVALID_TIME;
+
+    /**
+     * @brief Parse timestamp into milliseconds since epoch.
+     * @param timestamp Timestamp in Event::TIME_FORMAT.
+     * @param msecs Milliseconds since epoch are stored here, if @p timestamp is valid.
+     * @return True, if @p timestamp is in Event::TIME_FORMAT and represents a valid datetime.
+     */
+    static bool parse(const QString& timestamp, qint64* msecs);
+
+    /**
+     * @brief Parse an array of timestamps into milliseconds since epoch. Format
+     *  of each timestamp is validated and split into fields with SIMD instructions
+     *  (SSE2) when the library is built for a processor supporting them, and one
+     *  character at a time otherwise. Consecutive equal timestamps are converted once.
+     * @param timestamps Timestamps in Event::TIME_FORMAT.
+     * @param count Number of timestamps.
+     * @param msecs Milliseconds since epoch are stored here, one for each timestamp.
+     *  INVALID_TIME is stored for invalid timestamps.
+     * @param allowSimd If false, SIMD instructions are not used.
+     * @return Number of invalid timestamps.
+     * @pre @p timestamps and @p msecs hold at least @p count elements.
+     */
+    static unsigned parseBatch(const QString* timestamps, unsigned count, qint64* msecs,
+                               bool allowSimd = true);
+
+    /**
+     * @brief Check, if parseBatch can use SIMD instructions.
+     * @return True, if SIMD decoding is built in.
+     */
+    static bool simdAvailable();
+
+    /**
+     * @brief Check, if timestamp is in Event::TIME_FORMAT and represents a valid datetime.
+     * @param timestamp Checked timestamp.
+     * @return True, if timestamp is valid.
+     */
+    static bool isValid(const QString& timestamp);
+
+    /**
+     * @brief Format time as a timestamp.
+     * @param msecs Milliseconds since epoch.
+     * @return Local time in Event::TIME_FORMAT.
+     */
+    static QString format(qint64 msecs);
+
+    /**
+     * @brief Get current time as a timestamp.
+     * @return Current local time in Event::TIME_FORMAT.
+     */
+    static QString now();
+};
+
+} // namespace EventTimerNS
+
+#endif // TIMESTAMP_HH
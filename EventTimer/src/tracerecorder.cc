@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Implements the TraceRecorder class defined in inc/tracerecorder.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "tracerecorder.hh"
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+
+namespace EventTimerNS
+{
+
+TraceRecorder::TraceRecorder(unsigned capacity) :
+    spans_(capacity), next_(0), dropped_(0), clock_()
+{
+    Q_ASSERT(capacity > 0);
+    clock_.start();
+}
+
+
+qint64 TraceRecorder::now() const
+{
+    return clock_.nsecsElapsed();
+}
+
+
+void TraceRecorder::record(const char* name, qint64 startNsec)
+{
+    qint64 end = clock_.nsecsElapsed();
+    // Slot is claimed only while the buffer has room. Index stops growing once the
+    // buffer is full (exceeding capacity at most by the number of racing threads),
+    // so it can not wrap around and overwrite stored spans.
+    if (next_.load(std::memory_order_relaxed) >= spans_.size()){
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    unsigned i = next_.fetch_add(1, std::memory_order_relaxed);
+    if (i >= spans_.size()){
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Span& s = spans_[i];
+    s.name = name;
+    s.startNsec = startNsec;
+    s.durationNsec = end - startNsec;
+    s.threadId = quint64(quintptr(QThread::currentThreadId()));
+}
+
+
+unsigned TraceRecorder::size() const
+{
+    return qMin(next_.load(std::memory_order_relaxed), unsigned(spans_.size()));
+}
+
+
+quint64 TraceRecorder::dropped() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+
+std::vector<TraceRecorder::Span> TraceRecorder::spans() const
+{
+    return std::vector<Span>(spans_.begin(), spans_.begin() + this->size());
+}
+
+
+void TraceRecorder::clear()
+{
+    next_.store(0);
+    dropped_.store(0);
+    clock_.restart();
+}
+
+
+bool TraceRecorder::writeChromeTrace(const QString& fileName, QString* error) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)){
+        *error = file.errorString();
+        return false;
+    }
+
+    // Complete events ('X') with times in microseconds. Thread ids are
+    // numbered in order of appearance, so that they stay readable.
+    QTextStream out(&file);
+    qint64 pid = QCoreApplication::applicationPid();
+    std::vector<quint64> threads;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    unsigned count = this->size();
+    for (unsigned i = 0; i < count; ++i){
+        const Span& s = spans_[i];
+        unsigned tid = 0;
+        while (tid < threads.size() && threads[tid] != s.threadId) ++tid;
+        if (tid == threads.size()) threads.push_back(s.threadId);
+
+        out << (i == 0 ? "\n" : ",\n")
+            << "{\"name\":\"" << s.name << "\",\"cat\":\"eventtimer\",\"ph\":\"X\",\"ts\":"
+            << QString::number(s.startNsec / 1000.0, 'f', 3) << ",\"dur\":"
+            << QString::number(s.durationNsec / 1000.0, 'f', 3) << ",\"pid\":" << pid
+            << ",\"tid\":" << tid + 1 << "}";
+    }
+    out << "\n]}\n";
+
+    out.flush();
+    if (out.status() != QTextStream::Ok){
+        *error = "Could not write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+} // namespace EventTimerNS
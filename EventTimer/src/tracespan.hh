@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @brief Defines the TraceSpan class and the USDT probe macros used for
+ *  tracing the EventTimer engine.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef TRACESPAN_HH
+#define TRACESPAN_HH
+
+#include "tracerecorder.hh"
+
+#ifdef EVENTTIMER_HAVE_SDT
+#include <sys/sdt.h>
+#define EVENTTIMER_PROBE(probe, name) DTRACE_PROBE1(eventtimer, probe, name)
+#else
+#define EVENTTIMER_PROBE(probe, name)
+#endif
+
+namespace EventTimerNS
+{
+
+/**
+ * @brief Traces the enclosing scope. Span is recorded into the recorder on
+ *  destruction, and USDT probes fire at both ends if the library is built
+ *  with probe support. Without a recorder, span does not read the clock.
+ */
+class TraceSpan
+{
+public:
+
+    /**
+     * @brief Constructor. Starts the span.
+     * @param recorder Recorder receiving the span, or nullptr if tracing is disabled.
+     * @param name Span name. Must point to a string with static storage duration.
+     */
+    TraceSpan(TraceRecorder* recorder, const char* name) :
+        recorder_(recorder), name_(name), start_(recorder != nullptr ? recorder->now() : 0)
+    {
+        EVENTTIMER_PROBE(span_begin, name);
+    }
+
+    /**
+     * @brief Destructor. Ends the span.
+     */
+    ~TraceSpan()
+    {
+        EVENTTIMER_PROBE(span_end, name_);
+        if (recorder_ != nullptr){
+            recorder_->record(name_, start_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+
+    TraceRecorder* recorder_;
+    const char* name_;
+    qint64 start_;
+};
+
+} // namespace EventTimerNS
+
+#endif // TRACESPAN_HH
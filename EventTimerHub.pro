@@ -5,5 +5,7 @@ CONFIG += ordered
 SUBDIRS += \
     EventTimer \
     UnitTests \
-    EventTimerExample
+    EventTimerExample \
+    EventTimerReplay \
+    BenchmarkCompare
 
@@ -0,0 +1,25 @@
+QT       += core
+
+QT       -= gui
+
+TARGET = EventTimerReplay
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+INCLUDEPATH += ../EventTimer/inc/
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../EventTimer/release/ -lEventTimer
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../EventTimer/debug/ -lEventTimer
+else:unix: LIBS += -L$$OUT_PWD/../EventTimer/ -lEventTimer
+
+TEMPLATE = app
+
+
+HEADERS += \
+    workload.hh \
+    replayer.hh
+
+SOURCES += \
+    main.cc \
+    workload.cc \
+    replayer.cc
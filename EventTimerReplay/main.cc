@@ -0,0 +1,230 @@
+/**
+ * @file
+ * @brief Workload generator and trace replay tool for the EventTimer component.
+ *  Generates traces from a workload shape (arrival rate, intervals, repeats,
+ *  STATIC/DYNAMIC mix, cancellations), and replays generated or recorded traces
+ *  through an EventTimer created with EventTimerBuilder. Replay reports
+ *  throughput, peak memory and firing lateness.
+ *
+ *  Examples:
+ *    EventTimerReplay generate --rate 1000 --duration 60 --output trace.csv
+ *    EventTimerReplay replay --trace trace.csv --speed 10 --profile fast
+ *    EventTimerReplay replay --rate 200 --duration 30 --refresh 0
+ *    EventTimerReplay replay --trace trace.csv --chrome-trace ticks.json
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <memory>
+#include "eventtimerbuilder.hh"
+#include "workload.hh"
+#include "replayer.hh"
+
+using namespace EventTimerNS;
+
+namespace
+{
+
+// Parse workload shape from options. Returns false and sets error on invalid values.
+bool parseShape(const QCommandLineParser& parser, WorkloadShape* shape, QString* error)
+{
+    bool ok = true;
+    auto real = [&](const char* name, double* value){
+        if (ok && parser.isSet(name)) *value = parser.value(name).toDouble(&ok);
+    };
+    auto whole = [&](const char* name, unsigned* value){
+        if (ok && parser.isSet(name)) *value = parser.value(name).toUInt(&ok);
+    };
+
+    double duration = shape->durationMsec / 1000.0;
+    double leadMin = shape->leadMinMsec / 1000.0;
+    double leadMax = shape->leadMaxMsec / 1000.0;
+    real("rate", &shape->arrivalRate);
+    real("duration", &duration);
+    real("lead-min", &leadMin);
+    real("lead-max", &leadMax);
+    real("repeating", &shape->repeatingRatio);
+    whole("interval-min", &shape->intervalMinMsec);
+    whole("interval-max", &shape->intervalMaxMsec);
+    whole("repeats-max", &shape->repeatsMax);
+    real("infinite", &shape->infiniteRatio);
+    real("static", &shape->staticRatio);
+    real("cancel", &shape->cancelRatio);
+    whole("names", &shape->nameCount);
+    whole("seed", &shape->seed);
+    shape->durationMsec = qint64(duration * 1000);
+    shape->leadMinMsec = qint64(leadMin * 1000);
+    shape->leadMaxMsec = qint64(leadMax * 1000);
+
+    if (!ok){
+        *error = "Invalid workload option value.";
+        return false;
+    }
+    if (shape->arrivalRate <= 0 || shape->leadMinMsec > shape->leadMaxMsec ||
+            shape->intervalMinMsec == 0 || shape->intervalMinMsec > shape->intervalMaxMsec ||
+            shape->nameCount == 0){
+        *error = "Inconsistent workload shape.";
+        return false;
+    }
+    return true;
+}
+
+
+void printReport(const Replayer::Report& r, unsigned operations)
+{
+    QTextStream out(stdout);
+    double seconds = qMax(qint64(1), r.elapsedMsec) / 1000.0;
+    out << "Operations:        " << operations << '\n'
+        << "Events added:      " << r.added << " (" << r.addFailures << " failed)\n"
+        << "Events cancelled:  " << r.cancelled << " (" << r.cancelFailures << " already fired or failed)\n"
+        << "Events fired:      " << r.fired << '\n'
+        << "Elapsed time (s):  " << seconds << '\n'
+        << "Throughput:        " << qint64(r.fired / seconds) << " fired/s, "
+        << qint64((r.added + r.cancelled) / seconds) << " operations/s\n"
+        << "Queue depth:       " << r.stats.queueDepth << '\n'
+        << "Checks:            " << r.stats.checks;
+    if (r.stats.checks != 0){
+        out << ", mean duration " << r.stats.checkTimeNsec / r.stats.checks / 1000 << " us";
+    }
+    out << '\n'
+        << "Database time (ms): " << r.stats.databaseTimeNsec / 1000000 << '\n'
+        << "Lateness (ms):     p50 " << r.lateness.percentile(50) << ", p99 " << r.lateness.percentile(99)
+        << ", p99.9 " << r.lateness.percentile(99.9) << ", max " << r.lateness.max() << '\n'
+        << "Peak memory (KiB): ";
+    if (r.peakMemoryKib < 0){
+        out << "n/a\n";
+    } else {
+        out << r.peakMemoryKib << '\n';
+    }
+}
+
+} // Anonymous namespace
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("EventTimerReplay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate EventTimer workload traces and replay them.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("mode", "'generate' writes a trace, 'replay' runs a trace through EventTimer.");
+    parser.addOptions({
+        {"trace", "Replay trace from <file> instead of generating it.", "file"},
+        {"output", "Write generated trace to <file>.", "file"},
+        {"rate", "Events added per second (default 100).", "rate"},
+        {"duration", "Trace length in seconds (default 60).", "seconds"},
+        {"lead-min", "Minimum time from adding to first occurence in seconds (default 1).", "seconds"},
+        {"lead-max", "Maximum time from adding to first occurence in seconds (default 60).", "seconds"},
+        {"repeating", "Fraction of repeating events (default 0.5).", "fraction"},
+        {"interval-min", "Minimum repeat interval in ms (default 1000).", "msec"},
+        {"interval-max", "Maximum repeat interval in ms (default 60000).", "msec"},
+        {"repeats-max", "Maximum repeat count (default 10).", "count"},
+        {"infinite", "Fraction of repeating events repeating infinitely (default 0.1).", "fraction"},
+        {"static", "Fraction of STATIC events (default 0.5).", "fraction"},
+        {"cancel", "Fraction of events cancelled before firing (default 0.05).", "fraction"},
+        {"names", "Number of distinct event names (default 100).", "count"},
+        {"seed", "Random seed (default 1).", "seed"},
+        {"speed", "Replay speed-up; trace times and intervals are divided by it (default 1).", "factor"},
+        {"tail", "Seconds to keep running after the last operation (default 5).", "seconds"},
+        {"db", "SQLite database file (default replayDB).", "file"},
+        {"refresh", "Timer refresh rate in ms, 0 for event-driven (default 1000).", "msec"},
+        {"profile", "SQLite profile: default, durable, balanced or fast (default balanced).", "name"},
+        {"cache", "Event cache size (default 0).", "count"},
+        {"chrome-trace", "Write Chrome trace of timer operations to <file>.", "file"}
+    });
+    parser.process(app);
+
+    QTextStream err(stderr);
+    QStringList args = parser.positionalArguments();
+    if (args.size() != 1 || (args.at(0) != "generate" && args.at(0) != "replay")){
+        parser.showHelp(1);
+    }
+
+    // Load or generate the trace.
+    std::vector<TraceOp> trace;
+    QString error;
+    if (parser.isSet("trace")){
+        if (!readTrace(parser.value("trace"), &trace, &error)){
+            err << error << '\n';
+            return 1;
+        }
+    } else {
+        WorkloadShape shape;
+        if (!parseShape(parser, &shape, &error)){
+            err << error << '\n';
+            return 1;
+        }
+        trace = generateTrace(shape);
+    }
+
+    if (args.at(0) == "generate"){
+        if (!parser.isSet("output")){
+            err << "Option --output is required in generate mode.\n";
+            return 1;
+        }
+        if (!writeTrace(trace, parser.value("output"), &error)){
+            err << error << '\n';
+            return 1;
+        }
+        QTextStream(stdout) << trace.size() << " operations written.\n";
+        return 0;
+    }
+
+    // Replay.
+    double speed = parser.isSet("speed") ? parser.value("speed").toDouble() : 1.0;
+    if (speed <= 0){
+        err << "Invalid speed.\n";
+        return 1;
+    }
+    scaleTrace(&trace, speed);
+
+    EventTimerBuilder::Configuration conf;
+    conf.dbType = "QSQLITE";
+    conf.dbName = parser.isSet("db") ? parser.value("db") : QString("replayDB");
+    conf.tableName = "events";
+    conf.refreshRateMsec = parser.isSet("refresh") ? parser.value("refresh").toInt() : 1000;
+    conf.eventCacheSize = parser.value("cache").toUInt();
+    QString profile = parser.isSet("profile") ? parser.value("profile") : QString("balanced");
+    if (profile == "durable"){
+        conf.databaseProfile = DatabaseProfile::durable();
+    } else if (profile == "balanced"){
+        conf.databaseProfile = DatabaseProfile::balanced();
+    } else if (profile == "fast"){
+        conf.databaseProfile = DatabaseProfile::fast();
+    } else if (profile != "default"){
+        err << "Unknown profile " << profile << '\n';
+        return 1;
+    }
+
+    std::unique_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    if (!timer->isValid()){
+        err << "Could not create timer: " << timer->errorString() << '\n';
+        return 1;
+    }
+    timer->clearAll();
+
+    std::unique_ptr<TraceRecorder> recorder;
+    if (parser.isSet("chrome-trace")){
+        recorder.reset(new TraceRecorder());
+        timer->setTraceRecorder(recorder.get());
+    }
+
+    qint64 tail = qint64((parser.isSet("tail") ? parser.value("tail").toDouble() : 5.0) * 1000);
+    Replayer replayer(timer.get(), trace, tail);
+    printReport(replayer.run(), trace.size());
+    timer->setTraceRecorder(nullptr);
+    timer->clearAll();
+
+    if (recorder != nullptr){
+        if (!recorder->writeChromeTrace(parser.value("chrome-trace"), &error)){
+            err << error << '\n';
+            return 1;
+        }
+        QTextStream(stdout) << recorder->size() << " spans traced, " << recorder->dropped() << " dropped.\n";
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @brief Implements the Replayer class defined in replayer.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "replayer.hh"
+#include <QDateTime>
+#include <QFile>
+
+namespace
+{
+
+// Peak resident set size of this process in KiB (Linux only), or -1.
+qint64 peakMemoryKib()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+
+    while (!status.atEnd()){
+        QByteArray line = status.readLine();
+        if (line.startsWith("VmHWM:")){
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+} // Anonymous namespace
+
+
+Replayer::Replayer(EventTimerNS::EventTimer* timer, const std::vector<TraceOp>& trace, qint64 tailMsec) :
+    QObject(), EventTimerNS::EventHandler(), timer_(timer), trace_(trace), tailMsec_(tailMsec),
+    next_(0), ids_(), stepTimer_(), clock_(), loop_(), report_()
+{
+    Q_ASSERT(timer != nullptr);
+    Q_ASSERT(timer->isValid());
+
+    report_.added = 0;
+    report_.addFailures = 0;
+    report_.cancelled = 0;
+    report_.cancelFailures = 0;
+    report_.fired = 0;
+    report_.elapsedMsec = 0;
+    report_.peakMemoryKib = -1;
+
+    stepTimer_.setSingleShot(true);
+    stepTimer_.setTimerType(Qt::PreciseTimer);
+    connect(&stepTimer_, SIGNAL(timeout()), this, SLOT(step()));
+}
+
+
+Replayer::Report Replayer::run()
+{
+    timer_->setEventHandler(this);
+    timer_->start();
+    clock_.start();
+
+    this->step();
+    loop_.exec();
+
+    timer_->stop();
+    report_.elapsedMsec = clock_.elapsed();
+    report_.peakMemoryKib = peakMemoryKib();
+    report_.stats = timer_->stats();
+    report_.lateness = timer_->firingLateness();
+    return report_;
+}
+
+
+void Replayer::notify(const EventTimerNS::Event&)
+{
+    ++report_.fired;
+}
+
+
+void Replayer::step()
+{
+    using EventTimerNS::Event;
+    qint64 now = clock_.elapsed();
+
+    for (; next_ < trace_.size() && trace_[next_].atMsec <= now; ++next_){
+        const TraceOp& op = trace_[next_];
+        if (op.kind == TraceOp::ADD){
+            Event e(op.name, QDateTime::currentDateTime().addMSecs(op.leadMsec).toString(Event::TIME_FORMAT),
+                    op.type, op.interval, op.repeats);
+            unsigned id = timer_->addEvent(&e);
+            if (id != Event::UNASSIGNED_ID){
+                ids_[op.key] = id;
+                ++report_.added;
+            } else {
+                ++report_.addFailures;
+            }
+        }
+        else {
+            auto it = ids_.find(op.key);
+            if (it != ids_.end() && timer_->getEvent(it->second).id() == it->second &&
+                    timer_->removeEvent(it->second)){
+                ++report_.cancelled;
+            } else {
+                ++report_.cancelFailures;
+            }
+            if (it != ids_.end()){
+                ids_.erase(it);
+            }
+        }
+    }
+
+    if (next_ < trace_.size()){
+        stepTimer_.start(int(qMax(qint64(0), trace_[next_].atMsec - clock_.elapsed())));
+    } else {
+        QTimer::singleShot(int(tailMsec_), &loop_, SLOT(quit()));
+    }
+}
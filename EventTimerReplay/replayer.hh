@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Defines the Replayer class, which feeds a trace through an EventTimer
+ *  and collects throughput, memory and lateness figures.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef REPLAYER_HH
+#define REPLAYER_HH
+
+#include <QObject>
+#include <QTimer>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <unordered_map>
+#include <vector>
+#include "eventtimer.hh"
+#include "workload.hh"
+
+/**
+ * @brief The Replayer class performs trace operations at their scheduled
+ *  times on the real clock and counts fired events.
+ */
+class Replayer : public QObject, public EventTimerNS::EventHandler
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Results of a replay.
+     */
+    struct Report
+    {
+        quint64 added;
+        quint64 addFailures;
+        quint64 cancelled;
+        quint64 cancelFailures; // Event had already fired or could not be removed.
+        quint64 fired;
+        qint64 elapsedMsec;
+        qint64 peakMemoryKib;   // -1 if not available.
+        EventTimerNS::EventTimer::Statistics stats;
+        EventTimerNS::LatencyHistogram lateness;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param timer Timer receiving the operations. Replayer sets itself as timer's event handler.
+     * @param trace Operations ordered by time.
+     * @param tailMsec Time to keep the timer running after the last operation.
+     * @pre timer != nullptr, timer is valid and not running.
+     */
+    Replayer(EventTimerNS::EventTimer* timer, const std::vector<TraceOp>& trace, qint64 tailMsec);
+
+    /**
+     * @brief Replay the trace. Runs an event loop until the trace and tail have passed.
+     * @return Replay results.
+     */
+    Report run();
+
+    /**
+     * @brief Count fired event.
+     */
+    virtual void notify(const EventTimerNS::Event& event);
+
+
+private slots:
+
+    // Perform operations whose time has come and wait for the next one.
+    void step();
+
+
+private:
+
+    EventTimerNS::EventTimer* timer_;
+    std::vector<TraceOp> trace_;
+    qint64 tailMsec_;
+    unsigned next_;
+    std::unordered_map<unsigned, unsigned> ids_; // Event ids by trace key.
+    QTimer stepTimer_;
+    QElapsedTimer clock_;
+    QEventLoop loop_;
+    Report report_;
+};
+
+#endif // REPLAYER_HH
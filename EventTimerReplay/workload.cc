@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @brief Implements functions defined in workload.hh.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include "workload.hh"
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <algorithm>
+#include <random>
+
+namespace
+{
+
+const QString TRACE_HEADER("# at_msec,op,key,name,lead_msec,interval_msec,repeats,type");
+
+
+bool opLess(const TraceOp& a, const TraceOp& b)
+{
+    return a.atMsec < b.atMsec;
+}
+
+} // Anonymous namespace
+
+
+WorkloadShape::WorkloadShape() :
+    arrivalRate(100), durationMsec(60000), leadMinMsec(1000), leadMaxMsec(60000),
+    repeatingRatio(0.5), intervalMinMsec(1000), intervalMaxMsec(60000), repeatsMax(10),
+    infiniteRatio(0.1), staticRatio(0.5), cancelRatio(0.05), nameCount(100), seed(1)
+{
+}
+
+
+std::vector<TraceOp> generateTrace(const WorkloadShape& shape)
+{
+    Q_ASSERT(shape.arrivalRate > 0);
+    Q_ASSERT(shape.leadMinMsec <= shape.leadMaxMsec);
+    Q_ASSERT(shape.intervalMinMsec > 0 && shape.intervalMinMsec <= shape.intervalMaxMsec);
+    Q_ASSERT(shape.nameCount > 0);
+
+    std::mt19937 random(shape.seed);
+    std::uniform_real_distribution<double> fraction(0.0, 1.0);
+    std::exponential_distribution<double> arrival(shape.arrivalRate / 1000.0);
+    std::uniform_int_distribution<qint64> lead(shape.leadMinMsec, shape.leadMaxMsec);
+    std::uniform_int_distribution<unsigned> interval(shape.intervalMinMsec, shape.intervalMaxMsec);
+    std::uniform_int_distribution<unsigned> repeats(1, qMax(1u, shape.repeatsMax));
+    std::uniform_int_distribution<unsigned> name(0, shape.nameCount - 1);
+
+    std::vector<TraceOp> trace;
+    unsigned key = 0;
+
+    // Arrivals form a Poisson process.
+    for (double at = arrival(random); at < shape.durationMsec; at += arrival(random)){
+        TraceOp op;
+        op.atMsec = qint64(at);
+        op.kind = TraceOp::ADD;
+        op.key = key++;
+        op.name = "event" + QString::number(name(random));
+        op.leadMsec = lead(random);
+        op.interval = 0;
+        op.repeats = 0;
+        if (fraction(random) < shape.repeatingRatio){
+            op.interval = interval(random);
+            op.repeats = fraction(random) < shape.infiniteRatio ?
+                        EventTimerNS::Event::INFINITE_REPEAT : repeats(random);
+        }
+        op.type = fraction(random) < shape.staticRatio ?
+                    EventTimerNS::Event::STATIC : EventTimerNS::Event::DYNAMIC;
+        trace.push_back(op);
+
+        // Cancelled events are removed before their first occurence.
+        if (fraction(random) < shape.cancelRatio){
+            TraceOp cancel;
+            cancel.atMsec = op.atMsec + qint64(fraction(random) * op.leadMsec);
+            cancel.kind = TraceOp::CANCEL;
+            cancel.key = op.key;
+            cancel.leadMsec = 0;
+            cancel.interval = 0;
+            cancel.repeats = 0;
+            cancel.type = EventTimerNS::Event::DYNAMIC;
+            trace.push_back(cancel);
+        }
+    }
+
+    std::stable_sort(trace.begin(), trace.end(), opLess);
+    return trace;
+}
+
+
+bool writeTrace(const std::vector<TraceOp>& trace, const QString& fileName, QString* error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)){
+        *error = file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << TRACE_HEADER << '\n';
+    for (const TraceOp& op : trace){
+        out << op.atMsec << ',';
+        if (op.kind == TraceOp::CANCEL){
+            out << "cancel," << op.key << '\n';
+            continue;
+        }
+        out << "add," << op.key << ',' << op.name << ',' << op.leadMsec << ',' << op.interval << ',';
+        if (op.repeats == EventTimerNS::Event::INFINITE_REPEAT){
+            out << "inf";
+        } else {
+            out << op.repeats;
+        }
+        out << ',' << (op.type == EventTimerNS::Event::STATIC ? "static" : "dynamic") << '\n';
+    }
+
+    out.flush();
+    if (out.status() != QTextStream::Ok){
+        *error = "Could not write " + fileName;
+        return false;
+    }
+    return true;
+}
+
+
+bool readTrace(const QString& fileName, std::vector<TraceOp>* trace, QString* error)
+{
+    Q_ASSERT(trace != nullptr);
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)){
+        *error = file.errorString();
+        return false;
+    }
+
+    trace->clear();
+    QTextStream in(&file);
+    unsigned lineNumber = 0;
+    while (!in.atEnd()){
+        QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        QStringList fields = line.split(',');
+        bool ok = fields.size() >= 3;
+        TraceOp op;
+        if (ok){
+            op.atMsec = fields.at(0).toLongLong(&ok);
+        }
+        if (ok){
+            op.key = fields.at(2).toUInt(&ok);
+        }
+        op.leadMsec = 0;
+        op.interval = 0;
+        op.repeats = 0;
+        op.type = EventTimerNS::Event::DYNAMIC;
+
+        if (ok && fields.at(1) == "cancel"){
+            op.kind = TraceOp::CANCEL;
+        }
+        else if (ok && fields.at(1) == "add" && fields.size() == 8){
+            op.kind = TraceOp::ADD;
+            op.name = fields.at(3);
+            bool leadOk, intervalOk, repeatsOk = true;
+            op.leadMsec = fields.at(4).toLongLong(&leadOk);
+            op.interval = fields.at(5).toUInt(&intervalOk);
+            if (fields.at(6) == "inf"){
+                op.repeats = EventTimerNS::Event::INFINITE_REPEAT;
+            } else {
+                op.repeats = fields.at(6).toUInt(&repeatsOk);
+            }
+            op.type = fields.at(7) == "static" ? EventTimerNS::Event::STATIC : EventTimerNS::Event::DYNAMIC;
+            ok = leadOk && intervalOk && repeatsOk && !op.name.isEmpty() &&
+                    (op.repeats == 0 || op.interval != 0);
+        }
+        else {
+            ok = false;
+        }
+
+        if (!ok){
+            *error = fileName + ":" + QString::number(lineNumber) + ": invalid operation.";
+            return false;
+        }
+        trace->push_back(op);
+    }
+
+    std::stable_sort(trace->begin(), trace->end(), opLess);
+    return true;
+}
+
+
+void scaleTrace(std::vector<TraceOp>* trace, double speed)
+{
+    Q_ASSERT(speed > 0);
+    for (TraceOp& op : *trace){
+        op.atMsec = qint64(op.atMsec / speed);
+        op.leadMsec = qint64(op.leadMsec / speed);
+        if (op.interval != 0){
+            op.interval = qMax(1u, unsigned(op.interval / speed));
+        }
+    }
+}
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @brief Defines the workload description, trace operations and the
+ *  functions generating, reading and writing traces.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#ifndef WORKLOAD_HH
+#define WORKLOAD_HH
+
+#include <QString>
+#include <vector>
+#include "event.hh"
+
+/**
+ * @brief Describes the shape of a workload without any real data.
+ */
+struct WorkloadShape
+{
+    /**
+     * @brief Constructor. Sets default values.
+     */
+    WorkloadShape();
+
+    /**
+     * @brief Number of new events added per second.
+     */
+    double arrivalRate;
+
+    /**
+     * @brief Length of the trace in milliseconds.
+     */
+    qint64 durationMsec;
+
+    /**
+     * @brief Range of times between adding an event and its first occurence (milliseconds).
+     */
+    qint64 leadMinMsec;
+    qint64 leadMaxMsec;
+
+    /**
+     * @brief Fraction of repeating events (0-1).
+     */
+    double repeatingRatio;
+
+    /**
+     * @brief Range of repeat intervals of repeating events (milliseconds).
+     */
+    unsigned intervalMinMsec;
+    unsigned intervalMaxMsec;
+
+    /**
+     * @brief Maximum repeat count of repeating events. Repeat counts are uniformly distributed in [1, repeatsMax].
+     */
+    unsigned repeatsMax;
+
+    /**
+     * @brief Fraction of repeating events that repeat infinitely (0-1).
+     */
+    double infiniteRatio;
+
+    /**
+     * @brief Fraction of STATIC events (0-1). Other events are DYNAMIC.
+     */
+    double staticRatio;
+
+    /**
+     * @brief Fraction of events cancelled before they have fired (0-1).
+     */
+    double cancelRatio;
+
+    /**
+     * @brief Number of distinct event names.
+     */
+    unsigned nameCount;
+
+    /**
+     * @brief Random number generator seed. Same shape and seed always generate the same trace.
+     */
+    unsigned seed;
+};
+
+
+/**
+ * @brief Single operation of a trace.
+ */
+struct TraceOp
+{
+    enum Kind {
+        ADD, CANCEL
+    };
+
+    /**
+     * @brief Time of the operation, in milliseconds from the beginning of the trace.
+     */
+    qint64 atMsec;
+
+    Kind kind;
+
+    /**
+     * @brief Identifies the added event. Cancel operations refer to the key of an add operation.
+     */
+    unsigned key;
+
+    // Following fields are used by add operations only.
+    QString name;
+    qint64 leadMsec;
+    unsigned interval;
+    unsigned repeats;
+    EventTimerNS::Event::Type type;
+};
+
+
+/**
+ * @brief Generate trace matching the shape.
+ * @param shape Workload shape.
+ * @return Operations ordered by time.
+ */
+std::vector<TraceOp> generateTrace(const WorkloadShape& shape);
+
+/**
+ * @brief Write trace into a CSV file.
+ * @param trace Written operations.
+ * @param fileName Path of the file.
+ * @param error Error message is stored here if writing fails.
+ * @return True, if trace was written.
+ */
+bool writeTrace(const std::vector<TraceOp>& trace, const QString& fileName, QString* error);
+
+/**
+ * @brief Read trace written by writeTrace (or recorded in the same format).
+ * @param fileName Path of the file.
+ * @param trace Operations are stored here, ordered by time.
+ * @param error Error message is stored here if reading fails.
+ * @return True, if trace was read.
+ */
+bool readTrace(const QString& fileName, std::vector<TraceOp>* trace, QString* error);
+
+/**
+ * @brief Scale trace times, so that it is replayed @p speed times faster.
+ * @param trace Scaled trace.
+ * @param speed Speed-up factor.
+ * @pre speed > 0.
+ */
+void scaleTrace(std::vector<TraceOp>* trace, double speed);
+
+#endif // WORKLOAD_HH
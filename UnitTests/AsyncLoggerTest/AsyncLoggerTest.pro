@@ -0,0 +1,22 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_asyncloggertest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH +=  ../../EventTimer/inc/
+
+DEPENDPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+SOURCES += \
+    tst_asyncloggertest.cc \
+    ../../EventTimer/src/asynclogger.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
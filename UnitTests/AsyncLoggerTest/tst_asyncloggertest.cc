@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::AsyncLogger class.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include <QMutex>
+#include <QSemaphore>
+#include <memory>
+#include "asynclogger.hh"
+
+
+/**
+ * @brief Logger stub that records messages. Optionally blocks on each message
+ *  until the test releases it.
+ */
+class RecordingLogger : public EventTimerNS::Logger
+{
+public:
+
+    RecordingLogger() : blocking(false)
+    {
+    }
+
+    void logMsg(const QString& msg)
+    {
+        this->log(LEVEL_INFO, msg);
+    }
+
+    void log(Level level, const QString& msg)
+    {
+        if (blocking){
+            entered.release();
+            gate.acquire();
+        }
+        QMutexLocker lock(&mutex);
+        messages.push_back(msg);
+        levels.push_back(level);
+    }
+
+    QStringList received()
+    {
+        QMutexLocker lock(&mutex);
+        return messages;
+    }
+
+    bool blocking;
+    QSemaphore entered;
+    QSemaphore gate;
+    QMutex mutex;
+    QStringList messages;
+    std::vector<Level> levels;
+};
+
+
+/**
+ * @brief Unit tests for the EventTimerNS::AsyncLogger class.
+ */
+class AsyncLoggerTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    AsyncLoggerTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test that messages are passed to target in order.
+     */
+    void deliveryOrderTest();
+
+    /**
+     * @brief Test filtering messages by level.
+     */
+    void levelFilterTest();
+
+    /**
+     * @brief Test that messages are dropped instead of blocking when the queue is full.
+     */
+    void dropWhenFullTest();
+
+    /**
+     * @brief Test that destructor passes remaining messages to target.
+     */
+    void destructorDrainsTest();
+};
+
+AsyncLoggerTest::AsyncLoggerTest()
+{
+}
+
+
+void AsyncLoggerTest::deliveryOrderTest()
+{
+    using EventTimerNS::Logger;
+    RecordingLogger target;
+    EventTimerNS::AsyncLogger logger(&target, 16);
+
+    // Flush before queue can get full.
+    QStringList expected;
+    for (int i=0; i<1000; ++i){
+        QString msg = "message" + QString::number(i);
+        expected.push_back(msg);
+        logger.log(i%2 == 0 ? Logger::LEVEL_INFO : Logger::LEVEL_ERROR, msg);
+        if (i % 8 == 7) logger.flush();
+    }
+    logger.flush();
+
+    QCOMPARE(logger.droppedMessages(), quint64(0));
+    QCOMPARE(target.received(), expected);
+    QCOMPARE(target.levels.at(1), Logger::LEVEL_ERROR);
+}
+
+
+void AsyncLoggerTest::levelFilterTest()
+{
+    using EventTimerNS::Logger;
+    RecordingLogger target;
+    EventTimerNS::AsyncLogger logger(&target, 16, Logger::LEVEL_WARNING);
+
+    QVERIFY(!logger.isEnabled(Logger::LEVEL_DEBUG));
+    QVERIFY(!logger.isEnabled(Logger::LEVEL_INFO));
+    QVERIFY(logger.isEnabled(Logger::LEVEL_WARNING));
+    QVERIFY(logger.isEnabled(Logger::LEVEL_ERROR));
+
+    logger.log(Logger::LEVEL_DEBUG, "debug");
+    logger.logMsg("info");
+    logger.log(Logger::LEVEL_ERROR, "error");
+    logger.flush();
+
+    QCOMPARE(target.received(), QStringList() << "error");
+    QCOMPARE(target.levels.size(), std::vector<Logger::Level>::size_type(1));
+    QCOMPARE(target.levels.at(0), Logger::LEVEL_ERROR);
+}
+
+
+void AsyncLoggerTest::dropWhenFullTest()
+{
+    using EventTimerNS::Logger;
+    const unsigned CAPACITY = 4;
+    RecordingLogger target;
+    target.blocking = true;
+    EventTimerNS::AsyncLogger logger(&target, CAPACITY);
+
+    // Wait until background thread is blocked in the target logger.
+    logger.logMsg("first");
+    target.entered.acquire();
+
+    // Fill the queue and overflow it.
+    for (unsigned i=0; i<CAPACITY+3; ++i){
+        logger.logMsg("queued" + QString::number(i));
+    }
+    QCOMPARE(logger.droppedMessages(), quint64(3));
+
+    // Release target logger.
+    target.blocking = false;
+    target.gate.release();
+    logger.flush();
+    QCOMPARE(target.received().size(), int(CAPACITY + 1));
+    QCOMPARE(target.received().last(), QString("queued" + QString::number(CAPACITY-1)));
+}
+
+
+void AsyncLoggerTest::destructorDrainsTest()
+{
+    RecordingLogger target;
+    {
+        EventTimerNS::AsyncLogger logger(&target, 100);
+        for (int i=0; i<100; ++i){
+            logger.logMsg("message" + QString::number(i));
+        }
+    }
+    QCOMPARE(target.received().size(), 100);
+}
+
+
+QTEST_APPLESS_MAIN(AsyncLoggerTest)
+
+#include "tst_asyncloggertest.moc"
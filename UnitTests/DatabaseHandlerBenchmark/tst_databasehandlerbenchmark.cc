@@ -6,9 +6,13 @@
 
 #include <QString>
 #include <QtTest>
+#include <QBuffer>
 #include <memory>
+#include <map>
 #include "databasehandler.hh"
 
+Q_DECLARE_METATYPE(EventTimerNS::DatabaseProfile)
+
 /**
  * @brief The DatabaseHandlerBenchmark clas
  *  implements benchmarking for the DatabaseHandler class.
@@ -22,6 +26,16 @@ public:
 
 private Q_SLOTS:
 
+    /**
+     * @brief Select big data test state of the current data row.
+     */
+    void init();
+
+    /**
+     * @brief Store big data test state of the current data row.
+     */
+    void cleanup();
+
     /**
      * @brief Benchmark DatabaseHandler constructor.
      */
@@ -80,6 +94,12 @@ private Q_SLOTS:
     void getThousandEvents();
     void getThousandEvents_data();
 
+    /**
+     * @brief Benchmark getting 1000 different events through a warm event cache.
+     */
+    void getThousandEventsCached();
+    void getThousandEventsCached_data();
+
     /**
      * @brief Benchmark getting 500 expired events from the database.
      */
@@ -116,11 +136,32 @@ private Q_SLOTS:
     void removeThousandEvents();
     void removeThousandEvents_data();
 
+    /**
+     * @brief Benchmark removing 1000 events from the database in a single batch.
+     */
+    void removeThousandEventsBatch();
+    void removeThousandEventsBatch_data();
+
+    /**
+     * @brief Benchmark importing a snapshot of 1000 events (compare to addThousandEvents).
+     */
+    void importThousandEvents();
+    void importThousandEvents_data();
+
 
 private:
 
     std::shared_ptr<EventTimerNS::DatabaseHandler>
-    initDB(QString dbType, QString dbName, QString tableName, QString dbHost, QString userName, QString password);
+    initDB(QString dbType, QString dbName, QString tableName, QString dbHost, QString userName, QString password,
+           const EventTimerNS::DatabaseProfile& profile, unsigned cacheSize = 0);
+
+    // Big data tests build on the previous test's database, separately for each data row.
+    struct DataSet
+    {
+        std::vector<EventTimerNS::Event> events;
+        QDateTime currentTime;
+    };
+    std::map<QString, DataSet> dataSets_;
 
     // Container for storing Events in big data tests.
     std::vector<EventTimerNS::Event> events_;
@@ -133,6 +174,23 @@ DatabaseHandlerBenchmark::DatabaseHandlerBenchmark()
 }
 
 
+void DatabaseHandlerBenchmark::init()
+{
+    DataSet& data = dataSets_[QTest::currentDataTag()];
+    events_.swap(data.events);
+    currentTime_ = data.currentTime;
+}
+
+
+void DatabaseHandlerBenchmark::cleanup()
+{
+    DataSet& data = dataSets_[QTest::currentDataTag()];
+    data.events.swap(events_);
+    data.currentTime = currentTime_;
+    events_.clear();
+}
+
+
 void DatabaseHandlerBenchmark::constructorBenchmark()
 {
     QFETCH(QString, dbType);
@@ -141,6 +199,7 @@ void DatabaseHandlerBenchmark::constructorBenchmark()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
 
     EventTimerNS::DatabaseHandler::DbSetup setup;
     setup.dbType = dbType;
@@ -149,6 +208,7 @@ void DatabaseHandlerBenchmark::constructorBenchmark()
     setup.dbHostName = dbHost;
     setup.userName = userName;
     setup.password = password;
+    setup.profile = profile;
 
     EventTimerNS::DatabaseHandler* h = nullptr;
     QBENCHMARK {
@@ -166,9 +226,23 @@ void DatabaseHandlerBenchmark::constructorBenchmark_data()
     QTest::addColumn<QString>("dbHost");
     QTest::addColumn<QString>("userName");
     QTest::addColumn<QString>("password");
+    QTest::addColumn<EventTimerNS::DatabaseProfile>("profile");
 
+    using EventTimerNS::DatabaseProfile;
     QTest::newRow("Local SQLite no authentication")
-            << "QSQLITE" << "SQLiteTestDB" << "events" << QString() << QString() << QString();
+            << "QSQLITE" << "SQLiteTestDB" << "events" << QString() << QString() << QString()
+            << DatabaseProfile();
+
+    // Each profile uses its own file, because journal mode is persistent.
+    QTest::newRow("Local SQLite durable profile")
+            << "QSQLITE" << "SQLiteTestDB_durable" << "events" << QString() << QString() << QString()
+            << DatabaseProfile::durable();
+    QTest::newRow("Local SQLite balanced profile")
+            << "QSQLITE" << "SQLiteTestDB_balanced" << "events" << QString() << QString() << QString()
+            << DatabaseProfile::balanced();
+    QTest::newRow("Local SQLite fast profile")
+            << "QSQLITE" << "SQLiteTestDB_fast" << "events" << QString() << QString() << QString()
+            << DatabaseProfile::fast();
 }
 
 
@@ -180,10 +254,11 @@ void DatabaseHandlerBenchmark::addEventBenchmark()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
     handler->clearAll();
 
     QBENCHMARK {
@@ -209,10 +284,11 @@ void DatabaseHandlerBenchmark::updateSingleBenchmark()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
     handler->clearAll();
 
     Event original("original", "2000-01-01 00:00:00:000", Event::DYNAMIC, 0, 0);
@@ -241,10 +317,11 @@ void DatabaseHandlerBenchmark::getEventSingle()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
     handler->clearAll();
 
     Event original("original", "2000-01-01 00:00:00:000", Event::DYNAMIC, 0, 0);
@@ -273,10 +350,11 @@ void DatabaseHandlerBenchmark::nextEventsBenchmark()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
     handler->clearAll();
 
     // Add 17 past events
@@ -316,10 +394,11 @@ void DatabaseHandlerBenchmark::addUpdateRemoveSingleEvent()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
     handler->clearAll();
 
     QBENCHMARK {
@@ -348,10 +427,11 @@ void DatabaseHandlerBenchmark::addThousandEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
     handler->clearAll();
     events_.clear();
 
@@ -401,11 +481,12 @@ void DatabaseHandlerBenchmark::updateThousandEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     // Create updated events.
     std::vector<Event> updated;
@@ -448,11 +529,12 @@ void DatabaseHandlerBenchmark::getThousandEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     // Update events_ -container.
     QBENCHMARK_ONCE {
@@ -474,6 +556,45 @@ void DatabaseHandlerBenchmark::getThousandEvents_data()
 }
 
 
+void DatabaseHandlerBenchmark::getThousandEventsCached()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
+    QVERIFY(events_.size() == 1000);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile, 1000);
+
+    // Warm up the cache.
+    for (unsigned i=0; i<events_.size(); ++i){
+        QVERIFY(handler->getEvent(events_[i].id()).id() != Event::UNASSIGNED_ID);
+    }
+    QCOMPARE(handler->statistics().cacheMisses.value(), quint64(1000));
+
+    QBENCHMARK_ONCE {
+        for (unsigned i=0; i<events_.size(); ++i){
+            events_[i] = handler->getEvent(events_[i].id());
+        }
+    }
+
+    // All events were served from the cache.
+    QCOMPARE(handler->statistics().cacheHits.value(), quint64(1000));
+    QCOMPARE(handler->statistics().cacheMisses.value(), quint64(1000));
+}
+
+
+void DatabaseHandlerBenchmark::getThousandEventsCached_data()
+{
+    constructorBenchmark_data();
+}
+
+
 void DatabaseHandlerBenchmark::get500ExpiredEvents()
 {
     QFETCH(QString, dbType);
@@ -482,11 +603,12 @@ void DatabaseHandlerBenchmark::get500ExpiredEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     // Get expired
     std::vector<Event> expired;
@@ -525,11 +647,12 @@ void DatabaseHandlerBenchmark::oneNextEventsFromThousandEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     QDateTime lastEventTime = QDateTime::fromString(handler->getEvent(999).timestamp(), Event::TIME_FORMAT);
     Event e("name1001", lastEventTime.addDays(1).toString(Event::TIME_FORMAT),
@@ -558,11 +681,12 @@ void DatabaseHandlerBenchmark::thousandNextEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     QDateTime firstEventTime = QDateTime::fromString(handler->getEvent(1000).timestamp(), Event::TIME_FORMAT);
     Event e("name1002", firstEventTime.addDays(1).toString(Event::TIME_FORMAT),
@@ -591,11 +715,12 @@ void DatabaseHandlerBenchmark::clear500DynamicEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     QBENCHMARK_ONCE {
         QVERIFY(handler->clearDynamic());
@@ -627,11 +752,12 @@ void DatabaseHandlerBenchmark::clear500Events()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     QBENCHMARK_ONCE {
         QVERIFY(handler->clearAll());
@@ -658,11 +784,12 @@ void DatabaseHandlerBenchmark::removeThousandEvents()
     QFETCH(QString, dbHost);
     QFETCH(QString, userName);
     QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
     QVERIFY(events_.size() == 1000);
 
     using namespace EventTimerNS;
     std::shared_ptr<DatabaseHandler> handler =
-            this->initDB(dbType, dbName, tableName, dbHost, userName, password);
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
 
     // Re-populate database.
     for (unsigned i=0; i<events_.size(); ++i){
@@ -686,8 +813,89 @@ void DatabaseHandlerBenchmark::removeThousandEvents_data()
 }
 
 
+void DatabaseHandlerBenchmark::removeThousandEventsBatch()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
+    QVERIFY(events_.size() == 1000);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
+
+    // Re-populate database.
+    std::vector<unsigned> ids;
+    for (unsigned i=0; i<events_.size(); ++i){
+        QVERIFY(handler->getEvent(events_[i].id()).id() == Event::UNASSIGNED_ID);
+        Event e = events_[i].copy();
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+        QCOMPARE(e.id(), events_[i].id());
+        ids.push_back(e.id());
+    }
+
+    QBENCHMARK_ONCE {
+        QVERIFY(handler->removeEvents(ids));
+    }
+
+    QCOMPARE(handler->eventCount(), quint64(0));
+}
+
+
+void DatabaseHandlerBenchmark::removeThousandEventsBatch_data()
+{
+    constructorBenchmark_data();
+}
+
+
+void DatabaseHandlerBenchmark::importThousandEvents()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
+    QVERIFY(events_.size() == 1000);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            this->initDB(dbType, dbName, tableName, dbHost, userName, password, profile);
+
+    // Re-populate database and take a snapshot of it.
+    for (unsigned i=0; i<events_.size(); ++i){
+        Event e = events_[i].copy();
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+    QBuffer snapshot;
+    QVERIFY(snapshot.open(QIODevice::ReadWrite));
+    QVERIFY(handler->exportSnapshot(&snapshot));
+    QVERIFY(handler->clearAll());
+    QVERIFY(snapshot.seek(0));
+
+    QBENCHMARK_ONCE {
+        QVERIFY(handler->importSnapshot(&snapshot));
+    }
+
+    QCOMPARE(handler->eventCount(), quint64(1000));
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerBenchmark::importThousandEvents_data()
+{
+    constructorBenchmark_data();
+}
+
+
 std::shared_ptr<EventTimerNS::DatabaseHandler>
-DatabaseHandlerBenchmark::initDB(QString dbType, QString dbName, QString tableName, QString dbHost, QString userName, QString password)
+DatabaseHandlerBenchmark::initDB(QString dbType, QString dbName, QString tableName, QString dbHost, QString userName, QString password,
+                                 const EventTimerNS::DatabaseProfile& profile, unsigned cacheSize)
 {
     EventTimerNS::DatabaseHandler::DbSetup setup;
     setup.dbType = dbType;
@@ -696,6 +904,8 @@ DatabaseHandlerBenchmark::initDB(QString dbType, QString dbName, QString tableNa
     setup.dbHostName = dbHost;
     setup.userName = userName;
     setup.password = password;
+    setup.cacheSize = cacheSize;
+    setup.profile = profile;
 
     std::shared_ptr<EventTimerNS::DatabaseHandler> h(new EventTimerNS::DatabaseHandler(setup));
     return h;
@@ -24,6 +24,13 @@ DEPENDPATH += \
 SOURCES += \
     tst_databasehandlertest.cc \
     ../../EventTimer/src/databasehandler.cc \
-    ../../EventTimer/src/event.cc
+    ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc \
+    ../../EventTimer/src/eventcache.cc \
+    ../../EventTimer/src/namepool.cc \
+    ../../EventTimer/src/eventbatch.cc \
+    ../../EventTimer/src/databaseprofile.cc \
+    ../../EventTimer/src/tracerecorder.cc \
+    ../../EventTimer/src/snapshot.cc
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"
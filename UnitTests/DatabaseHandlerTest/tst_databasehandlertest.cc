@@ -7,8 +7,49 @@
 #include <QString>
 #include <QtTest>
 #include <QDateTime>
+#include <QSqlQuery>
+#include <QThread>
+#include <QBuffer>
 #include "databasehandler.hh"
+#include "snapshot.hh"
 #include <memory>
+#include <map>
+#include <limits>
+
+Q_DECLARE_METATYPE(EventTimerNS::DatabaseProfile)
+
+
+/**
+ * @brief Thread reading events repeatedly while the main thread modifies the database.
+ */
+class ReaderThread : public QThread
+{
+public:
+
+    ReaderThread(EventTimerNS::DatabaseHandler* handler, const std::vector<EventTimerNS::Event>& events) :
+        QThread(), handler(handler), events(events), failures(0), errorString()
+    {
+    }
+
+    EventTimerNS::DatabaseHandler* handler;
+    std::vector<EventTimerNS::Event> events;
+    int failures;
+    QString errorString;  // Error string seen by the thread after reading.
+
+protected:
+
+    virtual void run()
+    {
+        for (int round=0; round<20; ++round){
+            for (const EventTimerNS::Event& e : events){
+                if (handler->getEvent(e.id()).name() != e.name()) ++failures;
+            }
+            if (handler->nextEvents("2000-01-01 00:00:00:000", 10).size() != 10) ++failures;
+        }
+        errorString = handler->errorString();
+        handler->releaseReaderConnection();
+    }
+};
 
 
 /**
@@ -52,6 +93,12 @@ private Q_SLOTS:
     void removeEventsTest();
     void removeEventsTest_data();
 
+    /**
+     * @brief Test removing multiple events at once.
+     */
+    void removeEventsBatchTest();
+    void removeEventsBatchTest_data();
+
     /**
      * @brief Test clearing dynamic events.
      */
@@ -64,6 +111,58 @@ private Q_SLOTS:
     void updateEventTest();
     void updateEventTest_data();
 
+    /**
+     * @brief Test changing event's time, interval and repeats.
+     */
+    void rescheduleEventTest();
+    void rescheduleEventTest_data();
+
+    /**
+     * @brief Test giving multiple events the same schedule.
+     */
+    void rescheduleEventsTest();
+    void rescheduleEventsTest_data();
+
+    /**
+     * @brief Test reading due times of all events.
+     */
+    void eventDueTimesTest();
+    void eventDueTimesTest_data();
+
+    /**
+     * @brief Test exporting and importing binary snapshots.
+     */
+    void snapshotTest();
+    void snapshotTest_data();
+
+    /**
+     * @brief Test that cached events stay up to date.
+     */
+    void eventCacheTest();
+    void eventCacheTest_data();
+
+    /**
+     * @brief Test that queried events with equal names share the name data.
+     */
+    void nameSharingTest();
+    void nameSharingTest_data();
+
+    /**
+     * @brief Test that SQLite performance profile is applied.
+     */
+    void databaseProfileTest();
+    void databaseProfileTest_data();
+
+    /**
+     * @brief Test reading from multiple threads while the writer modifies events.
+     */
+    void concurrentReadersTest();
+
+    /**
+     * @brief Test that reads fail on threads that get no reader connection.
+     */
+    void noReaderConnectionTest();
+
     /**
      * @brief Test checking occured events.
      */
@@ -76,6 +175,18 @@ private Q_SLOTS:
     void nextEventsTest();
     void nextEventsTest_data();
 
+    /**
+     * @brief Test paging through events within a time range.
+     */
+    void eventsBetweenTest();
+    void eventsBetweenTest_data();
+
+    /**
+     * @brief Test getting multiple events by id.
+     */
+    void getEventsTest();
+    void getEventsTest_data();
+
     /**
      * @brief Test adding event and removing them imediately.
      */
@@ -288,6 +399,66 @@ void DatabaseHandlerTest::removeEventsTest_data()
 }
 
 
+void DatabaseHandlerTest::removeEventsBatchTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+
+    // Populate database with more events than fit into a single statement.
+    QDateTime current = QDateTime::currentDateTime();
+    std::vector<Event> events;
+    for (int i=1; i<=1200; ++i){
+        Event e("name" + QString::number(i),
+                current.addSecs(i).toString(Event::TIME_FORMAT), Event::DYNAMIC);
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+        events.push_back(e);
+    }
+
+    // Remove every event except each tenth. Include an unknown id.
+    std::vector<unsigned> removed;
+    for (unsigned i=0; i<events.size(); ++i){
+        if (i%10 != 0) removed.push_back(events[i].id());
+    }
+    removed.push_back(events.back().id() + 1000);
+    quint64 deletes = handler->statistics().deleteStatements.value();
+
+    unsigned deleted = 0;
+    QVERIFY(handler->removeEvents(removed, &deleted));
+    QVERIFY(handler->isValid());
+    QCOMPARE(deleted, unsigned(removed.size() - 1));
+    QCOMPARE(handler->statistics().deleteStatements.value(), deletes + 3);
+    QCOMPARE(handler->eventCount(), quint64(120));
+    for (unsigned i=0; i<events.size(); ++i){
+        Event tmp = handler->getEvent(events[i].id());
+        if (i%10 != 0){
+            QCOMPARE(tmp.id(), Event::UNASSIGNED_ID);
+        } else {
+            this->compareEvents(tmp, events[i]);
+        }
+    }
+
+    // Empty batch is a no-op.
+    QVERIFY(handler->removeEvents(std::vector<unsigned>(), &deleted));
+    QCOMPARE(deleted, 0u);
+    QCOMPARE(handler->eventCount(), quint64(120));
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::removeEventsBatchTest_data()
+{
+    addEventsTest_data();
+}
+
+
 void DatabaseHandlerTest::clearDynamicTest()
 {
     QFETCH(QString, dbType);
@@ -399,6 +570,460 @@ void DatabaseHandlerTest::updateEventTest_data()
 }
 
 
+void DatabaseHandlerTest::rescheduleEventTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+
+    Event e("name", "2016-01-01 00:00:00:000", Event::STATIC, 1000, 5);
+    unsigned id = handler->addEvent(&e);
+    QVERIFY(id != Event::UNASSIGNED_ID);
+
+    // Reschedule existing event.
+    QVERIFY(handler->rescheduleEvent(id, "2017-02-03 04:05:06:007", 2000, Event::INFINITE_REPEAT));
+    QVERIFY(handler->errorString().isEmpty());
+    Event expected("name", "2017-02-03 04:05:06:007", Event::STATIC, 2000, Event::INFINITE_REPEAT);
+    expected.setId(id);
+    this->compareEvents(handler->getEvent(id), expected);
+
+    // Repeats without interval are rejected.
+    QVERIFY(!handler->rescheduleEvent(id, "2018-01-01 00:00:00:000", 0, 3));
+    QVERIFY(!handler->errorString().isEmpty());
+    this->compareEvents(handler->getEvent(id), expected);
+
+    // Reschedule non-existing event.
+    QVERIFY(!handler->rescheduleEvent(id+1, "2017-02-03 04:05:06:007", 0, 0));
+    QCOMPARE(handler->errorString(), QString("No such event."));
+    QVERIFY(handler->isValid());
+    QCOMPARE(handler->eventCount(), quint64(1));
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::rescheduleEventTest_data()
+{
+    addEventsTest_data();
+}
+
+
+void DatabaseHandlerTest::rescheduleEventsTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+
+    std::vector<Event> events;
+    for (int i=0; i<3; ++i){
+        Event e("name" + QString::number(i), "2016-01-01 00:00:00:000", Event::STATIC, 1000, 5);
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+        events.push_back(e);
+    }
+    quint64 updates = handler->statistics().updateStatements.value();
+
+    // Reschedule two events and a non-existing one with a single statement.
+    std::vector<unsigned> ids = {events.at(0).id(), events.at(2).id(), events.at(2).id()+1};
+    QVERIFY(handler->rescheduleEvents(ids, "2017-02-03 04:05:06:007", 2000, 3));
+    QCOMPARE(handler->statistics().updateStatements.value(), updates + 1);
+
+    for (int i=0; i<3; i+=2){
+        Event expected(events.at(i).name(), "2017-02-03 04:05:06:007", Event::STATIC, 2000, 3);
+        expected.setId(events.at(i).id());
+        this->compareEvents(handler->getEvent(events.at(i).id()), expected);
+    }
+    this->compareEvents(handler->getEvent(events.at(1).id()), events.at(1));
+
+    QVERIFY(handler->rescheduleEvents(std::vector<unsigned>(), "2017-02-03 04:05:06:007", 0, 0));
+    QCOMPARE(handler->statistics().updateStatements.value(), updates + 1);
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::rescheduleEventsTest_data()
+{
+    addEventsTest_data();
+}
+
+
+void DatabaseHandlerTest::eventDueTimesTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+    QVERIFY(handler->eventDueTimes().empty());
+    QVERIFY(handler->errorString().isEmpty());
+
+    // Events sharing timestamps and events in reverse time order.
+    std::map<unsigned, qint64> expected;
+    QStringList timestamps = {"2017-01-01 00:00:00:000", "2016-05-16 12:34:56:789",
+                              "2016-05-16 12:34:56:789", "2016-01-01 00:00:00:001"};
+    for (const QString& timestamp : timestamps){
+        Event e("name", timestamp, Event::STATIC, 0, 0);
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+        expected[e.id()] = QDateTime::fromString(timestamp, Event::TIME_FORMAT).toMSecsSinceEpoch();
+    }
+
+    std::vector<std::pair<unsigned, qint64> > dueTimes = handler->eventDueTimes();
+    QVERIFY(handler->errorString().isEmpty());
+    QCOMPARE(dueTimes.size(), expected.size());
+    for (const std::pair<unsigned, qint64>& entry : dueTimes){
+        QVERIFY(expected.find(entry.first) != expected.end());
+        QCOMPARE(entry.second, expected[entry.first]);
+    }
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::eventDueTimesTest_data()
+{
+    addEventsTest_data();
+}
+
+
+void DatabaseHandlerTest::snapshotTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+
+    std::vector<Event> events = {
+        Event("name1", "2016-05-16 12:34:56:789", Event::STATIC, 0, 0),
+        Event("name2", "2016-01-01 00:00:00:001", Event::DYNAMIC, 1000, Event::INFINITE_REPEAT),
+        Event("name1", "2016-05-16 12:34:56:789", Event::DYNAMIC, 10, 3),
+        Event("name3", "2017-01-01 00:00:00:000", Event::STATIC, 60000, 1)
+    };
+    for (Event& e : events){
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+
+    QBuffer snapshot;
+    QVERIFY(snapshot.open(QIODevice::WriteOnly));
+    QVERIFY(handler->exportSnapshot(&snapshot));
+    QVERIFY(handler->errorString().isEmpty());
+    snapshot.close();
+
+    // Events and their ids are restored.
+    QVERIFY(handler->clearAll());
+    QVERIFY(snapshot.open(QIODevice::ReadOnly));
+    QVERIFY(handler->importSnapshot(&snapshot));
+    QVERIFY(handler->errorString().isEmpty());
+    snapshot.close();
+    QCOMPARE(handler->eventCount(), quint64(events.size()));
+    for (const Event& e : events){
+        this->compareEvents(handler->getEvent(e.id()), e);
+    }
+
+    // Importing existing ids fails without adding anything.
+    QVERIFY(snapshot.open(QIODevice::ReadOnly));
+    QVERIFY(!handler->importSnapshot(&snapshot));
+    QVERIFY(!handler->errorString().isEmpty());
+    snapshot.close();
+    QCOMPARE(handler->eventCount(), quint64(events.size()));
+
+    // Truncated snapshot is rejected and rolled back.
+    QVERIFY(handler->clearAll());
+    QBuffer truncated;
+    truncated.setData(snapshot.data().left(snapshot.data().size() - 2));
+    QVERIFY(truncated.open(QIODevice::ReadOnly));
+    QVERIFY(!handler->importSnapshot(&truncated));
+    QVERIFY(!handler->errorString().isEmpty());
+    QCOMPARE(handler->eventCount(), quint64(0));
+
+    // Data that is not a snapshot is rejected.
+    QBuffer garbage;
+    garbage.setData("name,timestamp\n");
+    QVERIFY(garbage.open(QIODevice::ReadOnly));
+    QVERIFY(!handler->importSnapshot(&garbage));
+    QCOMPARE(handler->eventCount(), quint64(0));
+
+    // Due time far outside the supported years is rejected before formatting.
+    QBuffer corrupted;
+    QVERIFY(corrupted.open(QIODevice::ReadWrite));
+    {
+        QDataStream out(&corrupted);
+        out.setVersion(QDataStream::Qt_5_0);
+        out << Snapshot::MAGIC << Snapshot::VERSION
+            << quint8(Snapshot::NAME) << QString("name")
+            << quint8(Snapshot::EVENT) << quint32(1) << quint32(0)
+            << std::numeric_limits<qint64>::max() << quint32(0) << quint32(0) << quint8(0)
+            << quint8(Snapshot::END) << quint32(1);
+    }
+    QVERIFY(corrupted.seek(0));
+    QVERIFY(!handler->importSnapshot(&corrupted));
+    QVERIFY(handler->errorString().contains("Corrupted"));
+    QCOMPARE(handler->eventCount(), quint64(0));
+
+    // Empty schedule.
+    QBuffer empty;
+    QVERIFY(empty.open(QIODevice::ReadWrite));
+    QVERIFY(handler->exportSnapshot(&empty));
+    QVERIFY(empty.seek(0));
+    QVERIFY(handler->importSnapshot(&empty));
+    QCOMPARE(handler->eventCount(), quint64(0));
+}
+
+
+void DatabaseHandlerTest::snapshotTest_data()
+{
+    addEventsTest_data();
+}
+
+
+void DatabaseHandlerTest::eventCacheTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    DatabaseHandler::DbSetup setup;
+    setup.dbType = dbType;
+    setup.dbName = dbName;
+    setup.tableName = tableName;
+    setup.dbHostName = dbHost;
+    setup.userName = userName;
+    setup.password = password;
+    setup.cacheSize = 2;
+    std::shared_ptr<DatabaseHandler> handler(new DatabaseHandler(setup));
+    verifyDbInitialization(handler);
+    const DatabaseHandler::Statistics& stats = handler->statistics();
+
+    Event e1("name1", "2016-01-01 00:00:00:000", Event::STATIC, 1000, 5);
+    Event e2("name2", "2016-01-02 00:00:00:000", Event::DYNAMIC, 1000, 5);
+    Event e3("name3", "2016-01-03 00:00:00:000", Event::DYNAMIC, 1000, 5);
+    QVERIFY(handler->addEvent(&e1) != Event::UNASSIGNED_ID);
+    QVERIFY(handler->addEvent(&e2) != Event::UNASSIGNED_ID);
+    QVERIFY(handler->addEvent(&e3) != Event::UNASSIGNED_ID);
+
+    // Two latest additions are cached. First one is loaded from db.
+    this->compareEvents(handler->getEvent(e3.id()), e3);
+    this->compareEvents(handler->getEvent(e2.id()), e2);
+    QCOMPARE(stats.cacheHits.value(), quint64(2));
+    QCOMPARE(stats.cacheMisses.value(), quint64(0));
+    this->compareEvents(handler->getEvent(e1.id()), e1);
+    QCOMPARE(stats.cacheMisses.value(), quint64(1));
+
+    // Updates are visible.
+    Event updated("updated", "2016-02-01 00:00:00:000", Event::STATIC, 10, 1);
+    updated.setId(e1.id());
+    QVERIFY(handler->updateEvent(e1.id(), updated));
+    this->compareEvents(handler->getEvent(e1.id()), updated);
+    QVERIFY(handler->rescheduleEvent(e1.id(), "2016-03-01 00:00:00:000", 20, 2));
+    Event tmp = handler->getEvent(e1.id());
+    QCOMPARE(tmp.timestamp(), QString("2016-03-01 00:00:00:000"));
+    QCOMPARE(tmp.interval(), 20u);
+    QCOMPARE(tmp.repeats(), 2u);
+    QCOMPARE(tmp.name(), QString("updated"));
+
+    // Removed events are not served from the cache.
+    QVERIFY(handler->removeEvent(e1.id()));
+    QCOMPARE(handler->getEvent(e1.id()).id(), Event::UNASSIGNED_ID);
+    QVERIFY(handler->errorString().isEmpty());
+    this->compareEvents(handler->getEvent(e2.id()), e2);
+    QVERIFY(handler->clearDynamic());
+    QCOMPARE(handler->getEvent(e2.id()).id(), Event::UNASSIGNED_ID);
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::eventCacheTest_data()
+{
+    addEventsTest_data();
+}
+
+
+void DatabaseHandlerTest::nameSharingTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+
+    for (int i=0; i<10; ++i){
+        Event e(i%2 == 0 ? "even" : "odd", "2016-01-01 00:00:00:00" + QString::number(i), Event::STATIC);
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+
+    std::vector<Event> events = handler->nextEvents("2000-01-01 00:00:00:000", 10);
+    QCOMPARE(events.size(), std::vector<Event>::size_type(10));
+    for (unsigned i=2; i<events.size(); ++i){
+        QCOMPARE(events.at(i).name(), events.at(i-2).name());
+        QVERIFY(events.at(i).name().constData() == events.at(i-2).name().constData());
+    }
+    QVERIFY(events.at(0).name().constData() != events.at(1).name().constData());
+
+    // Names are shared between queries.
+    std::vector<Event> expired = handler->checkOccured("2016-01-01 00:00:00:005");
+    QCOMPARE(expired.size(), std::vector<Event>::size_type(5));
+    QVERIFY(expired.at(0).name().constData() == events.at(0).name().constData());
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::nameSharingTest_data()
+{
+    addEventsTest_data();
+}
+
+
+void DatabaseHandlerTest::databaseProfileTest()
+{
+    QFETCH(QString, dbName);
+    QFETCH(EventTimerNS::DatabaseProfile, profile);
+    QFETCH(QString, journalMode);
+
+    using namespace EventTimerNS;
+    DatabaseHandler::DbSetup setup;
+    setup.dbType = "QSQLITE";
+    setup.dbName = dbName;
+    setup.tableName = "events";
+    setup.profile = profile;
+    std::shared_ptr<DatabaseHandler> handler(new DatabaseHandler(setup));
+    verifyDbInitialization(handler);
+
+    Event e("name", "2016-01-01 00:00:00:000", Event::STATIC);
+    QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+    this->compareEvents(handler->getEvent(e.id()), e);
+
+    // Journal mode is a property of the database file. Check it with another connection.
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "databaseProfileTest");
+        db.setDatabaseName(dbName);
+        QVERIFY(db.open());
+        QSqlQuery q("PRAGMA journal_mode", db);
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toString().toUpper(), journalMode);
+    }
+    QSqlDatabase::removeDatabase("databaseProfileTest");
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::databaseProfileTest_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<EventTimerNS::DatabaseProfile>("profile");
+    QTest::addColumn<QString>("journalMode");
+
+    using EventTimerNS::DatabaseProfile;
+    DatabaseProfile rollback;
+    rollback.journalMode = "DELETE";
+    QTest::newRow("Rollback journal") << "SQLiteProfileTestDB_delete" << rollback << "DELETE";
+    QTest::newRow("Durable") << "SQLiteProfileTestDB_durable" << DatabaseProfile::durable() << "WAL";
+    QTest::newRow("Balanced") << "SQLiteProfileTestDB_balanced" << DatabaseProfile::balanced() << "WAL";
+}
+
+
+void DatabaseHandlerTest::concurrentReadersTest()
+{
+    using namespace EventTimerNS;
+    DatabaseHandler::DbSetup setup;
+    setup.dbType = "QSQLITE";
+    setup.dbName = "SQLiteReaderTestDB";
+    setup.tableName = "events";
+    setup.profile = DatabaseProfile::balanced();
+    setup.readerConnections = 4;
+    std::shared_ptr<DatabaseHandler> handler(new DatabaseHandler(setup));
+    verifyDbInitialization(handler);
+
+    std::vector<Event> events;
+    for (int i=0; i<100; ++i){
+        Event e("name" + QString::number(i), "2016-01-01 00:00:00:000", Event::STATIC, 1000, 5);
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+        events.push_back(e);
+    }
+
+    std::vector<std::shared_ptr<ReaderThread> > readers;
+    for (int i=0; i<4; ++i){
+        readers.push_back(std::make_shared<ReaderThread>(handler.get(), events));
+        readers.back()->start();
+    }
+
+    // Modify events while readers are running.
+    QDateTime time = QDateTime::fromString("2016-01-02 00:00:00:000", Event::TIME_FORMAT);
+    for (int round=0; round<5; ++round){
+        for (const Event& e : events){
+            time = time.addMSecs(1);
+            QVERIFY(handler->rescheduleEvent(e.id(), time.toString(Event::TIME_FORMAT), 1000, 5));
+        }
+    }
+
+    for (std::shared_ptr<ReaderThread> reader : readers){
+        QVERIFY(reader->wait(60000));
+        QCOMPARE(reader->failures, 0);
+    }
+    QCOMPARE(handler->getEvent(events.back().id()).timestamp(), time.toString(Event::TIME_FORMAT));
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::noReaderConnectionTest()
+{
+    using namespace EventTimerNS;
+    DatabaseHandler::DbSetup setup;
+    setup.dbType = "QSQLITE";
+    setup.dbName = "SQLiteNoReaderTestDB";
+    setup.tableName = "events";
+    std::shared_ptr<DatabaseHandler> handler(new DatabaseHandler(setup));
+    verifyDbInitialization(handler);
+
+    Event e("name", "2016-01-01 00:00:00:000", Event::STATIC);
+    QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+
+    // Writer connection is not shared with other threads.
+    ReaderThread reader(handler.get(), std::vector<Event>(1, e));
+    reader.start();
+    QVERIFY(reader.wait(60000));
+    QCOMPARE(reader.failures, 40);
+    QVERIFY(!reader.errorString.isEmpty());
+
+    // Failure of the reader is not seen as a failure of the writer thread.
+    QVERIFY(handler->errorString().isEmpty());
+
+    // Writer thread still reads through its own connection.
+    QCOMPARE(handler->getEvent(e.id()).name(), e.name());
+    QVERIFY(handler->isValid());
+    QVERIFY(handler->clearAll());
+}
+
+
 void DatabaseHandlerTest::checkOccuredTest()
 {
     QFETCH(QString, dbType);
@@ -501,6 +1126,100 @@ void DatabaseHandlerTest::nextEventsTest_data()
 }
 
 
+void DatabaseHandlerTest::eventsBetweenTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+
+    // Pairs of events share a timestamp, one second apart.
+    QDateTime start = QDateTime::fromString("2016-01-01 00:00:00:000", Event::TIME_FORMAT);
+    std::vector<Event> events;
+    for (int i=0; i<20; ++i){
+        Event e("name" + QString::number(i),
+                start.addSecs(i/2).toString(Event::TIME_FORMAT), Event::DYNAMIC);
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+        events.push_back(e);
+    }
+
+    // Page through [start+1s, start+8s) three events at a time.
+    QString from = start.addSecs(1).toString(Event::TIME_FORMAT);
+    QString to = start.addSecs(8).toString(Event::TIME_FORMAT);
+    std::vector<Event> received;
+    std::vector<Event> page = handler->eventsBetween(from, to, 3);
+    while (!page.empty()){
+        QVERIFY(page.size() <= 3);
+        received.insert(received.end(), page.begin(), page.end());
+        const Event& last = page.back();
+        page = handler->eventsBetween(from, to, 3, last.timestamp(), last.id());
+    }
+    QVERIFY(handler->errorString().isEmpty());
+
+    QCOMPARE(received.size(), std::vector<Event>::size_type(14));
+    for (unsigned i=0; i<received.size(); ++i){
+        this->compareEvents(received[i], events[i+2]);
+    }
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::eventsBetweenTest_data()
+{
+    addEventsTest_data();
+}
+
+
+void DatabaseHandlerTest::getEventsTest()
+{
+    QFETCH(QString, dbType);
+    QFETCH(QString, dbName);
+    QFETCH(QString, tableName);
+    QFETCH(QString, dbHost);
+    QFETCH(QString, userName);
+    QFETCH(QString, password);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<DatabaseHandler> handler =
+            setupDB(dbType, dbName, tableName, dbHost, userName, password);
+
+    std::vector<Event> events;
+    for (int i=0; i<10; ++i){
+        Event e("name" + QString::number(i), "2016-01-01 00:00:00:000", Event::STATIC, i, i);
+        QVERIFY(handler->addEvent(&e) != Event::UNASSIGNED_ID);
+        events.push_back(e);
+    }
+
+    // Reversed order with an unknown id in the middle.
+    std::vector<unsigned> ids;
+    for (int i=9; i>=5; --i){
+        ids.push_back(events[i].id());
+    }
+    ids.insert(ids.begin() + 2, events.back().id() + 100);
+
+    std::vector<Event> result = handler->getEvents(ids);
+    QVERIFY(handler->errorString().isEmpty());
+    QCOMPARE(result.size(), std::vector<Event>::size_type(5));
+    for (unsigned i=0; i<result.size(); ++i){
+        this->compareEvents(result[i], events[9-i]);
+    }
+    QVERIFY(handler->getEvents(std::vector<unsigned>()).empty());
+    QVERIFY(handler->clearAll());
+}
+
+
+void DatabaseHandlerTest::getEventsTest_data()
+{
+    addEventsTest_data();
+}
+
+
 void DatabaseHandlerTest::addRemoveTest()
 {
     QFETCH(QString, dbType);
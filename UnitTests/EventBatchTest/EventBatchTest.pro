@@ -0,0 +1,26 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_eventbatchtest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+DEPENDPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+SOURCES += \
+    tst_eventbatchtest.cc \
+    ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc \
+    ../../EventTimer/src/eventbatch.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
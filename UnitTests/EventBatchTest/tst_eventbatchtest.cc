@@ -0,0 +1,211 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::EventBatch class.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "eventbatch.hh"
+#include "timestamp.hh"
+
+
+namespace
+{
+
+// Number of heap allocations made by the test process.
+std::atomic<quint64> allocations(0);
+
+} // Anonymous namespace
+
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+/**
+ * @brief Unit tests for the EventTimerNS::EventBatch class.
+ */
+class EventBatchTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    EventBatchTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test appending and iterating events.
+     */
+    void appendTest();
+
+    /**
+     * @brief Test that clearing keeps the event objects for reuse.
+     */
+    void reuseTest();
+
+    /**
+     * @brief Test that refilling a batch up to its earlier size does not allocate memory.
+     */
+    void steadyStateAllocationTest();
+    void steadyStateAllocationTest_data();
+
+    /**
+     * @brief Test decoding due times of the events.
+     */
+    void dueTimeTest();
+
+private:
+
+    // Refill batch with copies of events and decode due times (as checking for occured events does).
+    void fill(EventTimerNS::EventBatch* batch, const std::vector<EventTimerNS::Event>& events,
+              unsigned count);
+};
+
+EventBatchTest::EventBatchTest()
+{
+}
+
+
+void EventBatchTest::appendTest()
+{
+    using EventTimerNS::Event;
+    EventTimerNS::EventBatch batch;
+    QVERIFY(batch.empty());
+    QVERIFY(batch.begin() == batch.end());
+
+    for (unsigned i=0; i<5; ++i){
+        Event* e = batch.append();
+        e->setId(i);
+        e->setName("name" + QString::number(i));
+    }
+
+    QCOMPARE(batch.size(), 5u);
+    QVERIFY(!batch.empty());
+    unsigned i = 0;
+    for (const Event& e : batch){
+        QCOMPARE(e.id(), i);
+        QCOMPARE(e.name(), "name" + QString::number(i));
+        QCOMPARE(batch.at(i).id(), i);
+        ++i;
+    }
+    QCOMPARE(i, 5u);
+}
+
+
+void EventBatchTest::reuseTest()
+{
+    EventTimerNS::EventBatch batch;
+    EventTimerNS::Event* first = batch.append();
+    batch.append();
+    batch.append();
+
+    batch.clear();
+    QVERIFY(batch.empty());
+    QCOMPARE(batch.size(), 0u);
+    QVERIFY(batch.begin() == batch.end());
+
+    // Slots are reused in order.
+    QVERIFY(batch.append() == first);
+    QCOMPARE(batch.size(), 1u);
+}
+
+
+void EventBatchTest::steadyStateAllocationTest()
+{
+    QFETCH(unsigned, count);
+
+    using EventTimerNS::Event;
+    std::vector<Event> events;
+    for (unsigned i=0; i<count; ++i){
+        Event e("name" + QString::number(i%10), "2016-01-01 00:00:00:000", Event::STATIC, 1000, i);
+        e.setId(i);
+        events.push_back(e);
+    }
+
+    // First fill grows the batch.
+    EventTimerNS::EventBatch batch;
+    quint64 before = allocations.load();
+    this->fill(&batch, events, count);
+    QVERIFY(allocations.load() > before);
+
+    // Refilling up to the same size reuses storage.
+    before = allocations.load();
+    for (int round=0; round<10; ++round){
+        this->fill(&batch, events, count);
+        this->fill(&batch, events, count/2);
+    }
+    quint64 allocated = allocations.load() - before;
+    QCOMPARE(allocated, quint64(0));
+    QCOMPARE(batch.size(), count/2);
+    QCOMPARE(batch.at(count/2 - 1).repeats(), count/2 - 1);
+}
+
+
+void EventBatchTest::steadyStateAllocationTest_data()
+{
+    QTest::addColumn<unsigned>("count");
+    QTest::newRow("10 events") << 10u;
+    QTest::newRow("1000 events") << 1000u;
+    QTest::newRow("100000 events") << 100000u;
+}
+
+
+void EventBatchTest::dueTimeTest()
+{
+    using EventTimerNS::Event;
+    using EventTimerNS::Timestamp;
+    QStringList timestamps = {"2016-01-01 00:00:00:000", "2016-01-01 00:00:00:000",
+                              "2016-05-16 12:34:56:789", "invalid"};
+    EventTimerNS::EventBatch batch;
+    for (const QString& timestamp : timestamps){
+        batch.append()->setTimestamp(timestamp);
+    }
+    batch.decodeDueTimes();
+
+    for (int i=0; i<3; ++i){
+        qint64 expected = 0;
+        QVERIFY(Timestamp::parse(timestamps.at(i), &expected));
+        QCOMPARE(batch.dueTime(i), expected);
+    }
+    QCOMPARE(batch.dueTime(3), Timestamp::INVALID_TIME);
+
+    // Decoding follows refilled batch.
+    batch.clear();
+    batch.append()->setTimestamp(timestamps.at(2));
+    batch.decodeDueTimes();
+    qint64 expected = 0;
+    Timestamp::parse(timestamps.at(2), &expected);
+    QCOMPARE(batch.dueTime(0), expected);
+}
+
+
+void EventBatchTest::fill(EventTimerNS::EventBatch* batch, const std::vector<EventTimerNS::Event>& events,
+                          unsigned count)
+{
+    batch->clear();
+    for (unsigned i=0; i<count; ++i){
+        *batch->append() = events[i];
+    }
+    batch->decodeDueTimes();
+}
+
+
+QTEST_APPLESS_MAIN(EventBatchTest)
+
+#include "tst_eventbatchtest.moc"
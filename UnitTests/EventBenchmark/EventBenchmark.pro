@@ -0,0 +1,25 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_eventbenchmark
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+DEPENDPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+SOURCES += \
+    tst_eventbenchmark.cc \
+    ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
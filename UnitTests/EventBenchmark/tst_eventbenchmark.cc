@@ -0,0 +1,347 @@
+/**
+ * @file
+ * @brief Benchmarking tests for the Event class and timestamp conversions.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include <QDateTime>
+#include <vector>
+#include "event.hh"
+#include "timestamp.hh"
+
+
+/**
+ * @brief The EventBenchmark class implements benchmarking for the Event class.
+ *  Each benchmark processes a batch of events, so that per-event costs are
+ *  visible also for cheap operations.
+ */
+class EventBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    EventBenchmark();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Prepare events and timestamps for the current data row.
+     */
+    void init();
+
+    /**
+     * @brief Benchmark constructing events with the full constructor.
+     */
+    void constructorBenchmark();
+    void constructorBenchmark_data();
+
+    /**
+     * @brief Benchmark default construction followed by setters (as decoding query rows does).
+     */
+    void settersBenchmark();
+    void settersBenchmark_data();
+
+    /**
+     * @brief Benchmark copy-constructing events.
+     */
+    void copyConstructorBenchmark();
+    void copyConstructorBenchmark_data();
+
+    /**
+     * @brief Benchmark Event::copy.
+     */
+    void copyMethodBenchmark();
+    void copyMethodBenchmark_data();
+
+    /**
+     * @brief Benchmark Event::isValid.
+     */
+    void isValidBenchmark();
+    void isValidBenchmark_data();
+
+    /**
+     * @brief Benchmark parsing timestamps into milliseconds since epoch.
+     */
+    void parseTimestampBenchmark();
+    void parseTimestampBenchmark_data();
+
+    /**
+     * @brief Benchmark formatting milliseconds since epoch into timestamps.
+     */
+    void formatTimestampBenchmark();
+    void formatTimestampBenchmark_data();
+
+    /**
+     * @brief Benchmark parsing timestamps with the fixed-format parser.
+     */
+    void fastParseTimestampBenchmark();
+    void fastParseTimestampBenchmark_data();
+
+    /**
+     * @brief Benchmark formatting timestamps with the fixed-format formatter.
+     */
+    void fastFormatTimestampBenchmark();
+    void fastFormatTimestampBenchmark_data();
+
+    /**
+     * @brief Benchmark parsing a batch of timestamps with and without SIMD decoding.
+     */
+    void batchParseTimestampBenchmark();
+    void batchParseTimestampBenchmark_data();
+
+private:
+
+    // Add data rows with different batch sizes.
+    void batchSizes();
+
+    std::vector<EventTimerNS::Event> events_;
+    std::vector<QString> timestamps_;
+    std::vector<qint64> times_;
+};
+
+
+EventBenchmark::EventBenchmark()
+{
+}
+
+
+void EventBenchmark::init()
+{
+    using EventTimerNS::Event;
+    events_.clear();
+    timestamps_.clear();
+    times_.clear();
+
+    // Distinct timestamps one second and some milliseconds apart.
+    QFETCH(unsigned, count);
+    QDateTime time = QDateTime::fromString("2016-01-01 00:00:00:000", Event::TIME_FORMAT);
+    for (unsigned i=0; i<count; ++i){
+        time = time.addMSecs(1007);
+        QString timestamp = time.toString(Event::TIME_FORMAT);
+        timestamps_.push_back(timestamp);
+        times_.push_back(time.toMSecsSinceEpoch());
+        events_.push_back(Event("event" + QString::number(i%100), timestamp, Event::STATIC, 1000, i));
+    }
+}
+
+
+void EventBenchmark::constructorBenchmark()
+{
+    using EventTimerNS::Event;
+    std::vector<Event> events;
+    events.reserve(timestamps_.size());
+    QString name("name");
+
+    QBENCHMARK {
+        events.clear();
+        for (const QString& timestamp : timestamps_){
+            events.emplace_back(name, timestamp, Event::STATIC, 1000, 10);
+        }
+    }
+    QCOMPARE(events.size(), timestamps_.size());
+}
+
+
+void EventBenchmark::constructorBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::settersBenchmark()
+{
+    using EventTimerNS::Event;
+    std::vector<Event> events;
+    events.reserve(timestamps_.size());
+    QString name("name");
+
+    QBENCHMARK {
+        events.clear();
+        for (unsigned i=0; i<timestamps_.size(); ++i){
+            events.emplace_back();
+            Event& e = events.back();
+            e.setId(i);
+            e.setName(name);
+            e.setTimestamp(timestamps_[i]);
+            e.setInterval(1000);
+            e.setRepeats(10);
+            e.setType(Event::STATIC);
+        }
+    }
+    QCOMPARE(events.size(), timestamps_.size());
+}
+
+
+void EventBenchmark::settersBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::copyConstructorBenchmark()
+{
+    std::vector<EventTimerNS::Event> copies;
+    QBENCHMARK {
+        copies = events_;
+    }
+    QCOMPARE(copies.size(), events_.size());
+}
+
+
+void EventBenchmark::copyConstructorBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::copyMethodBenchmark()
+{
+    using EventTimerNS::Event;
+    std::vector<Event> copies;
+    copies.reserve(events_.size());
+
+    QBENCHMARK {
+        copies.clear();
+        for (const Event& e : events_){
+            copies.push_back(e.copy());
+        }
+    }
+    QCOMPARE(copies.size(), events_.size());
+}
+
+
+void EventBenchmark::copyMethodBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::isValidBenchmark()
+{
+    unsigned valid = 0;
+    QBENCHMARK {
+        valid = 0;
+        for (const EventTimerNS::Event& e : events_){
+            if (e.isValid()) ++valid;
+        }
+    }
+    QCOMPARE(valid, unsigned(events_.size()));
+}
+
+
+void EventBenchmark::isValidBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::parseTimestampBenchmark()
+{
+    std::vector<qint64> times(timestamps_.size());
+    QBENCHMARK {
+        for (unsigned i=0; i<timestamps_.size(); ++i){
+            times[i] = QDateTime::fromString(timestamps_[i], EventTimerNS::Event::TIME_FORMAT).toMSecsSinceEpoch();
+        }
+    }
+    QVERIFY(times == times_);
+}
+
+
+void EventBenchmark::parseTimestampBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::formatTimestampBenchmark()
+{
+    std::vector<QString> timestamps(times_.size());
+    QBENCHMARK {
+        for (unsigned i=0; i<times_.size(); ++i){
+            timestamps[i] = QDateTime::fromMSecsSinceEpoch(times_[i]).toString(EventTimerNS::Event::TIME_FORMAT);
+        }
+    }
+    QVERIFY(timestamps == timestamps_);
+}
+
+
+void EventBenchmark::formatTimestampBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::fastParseTimestampBenchmark()
+{
+    std::vector<qint64> times(timestamps_.size());
+    QBENCHMARK {
+        for (unsigned i=0; i<timestamps_.size(); ++i){
+            EventTimerNS::Timestamp::parse(timestamps_[i], &times[i]);
+        }
+    }
+    QVERIFY(times == times_);
+}
+
+
+void EventBenchmark::fastParseTimestampBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::fastFormatTimestampBenchmark()
+{
+    std::vector<QString> timestamps(times_.size());
+    QBENCHMARK {
+        for (unsigned i=0; i<times_.size(); ++i){
+            timestamps[i] = EventTimerNS::Timestamp::format(times_[i]);
+        }
+    }
+    QVERIFY(timestamps == timestamps_);
+}
+
+
+void EventBenchmark::fastFormatTimestampBenchmark_data()
+{
+    batchSizes();
+}
+
+
+void EventBenchmark::batchParseTimestampBenchmark()
+{
+    QFETCH(bool, allowSimd);
+    std::vector<qint64> times(timestamps_.size());
+    QBENCHMARK {
+        EventTimerNS::Timestamp::parseBatch(timestamps_.data(), timestamps_.size(), times.data(), allowSimd);
+    }
+    QVERIFY(times == times_);
+}
+
+
+void EventBenchmark::batchParseTimestampBenchmark_data()
+{
+    QTest::addColumn<unsigned>("count");
+    QTest::addColumn<bool>("allowSimd");
+    for (unsigned count : {1u, 1000u, 100000u}){
+        QTest::newRow(qPrintable(QString::number(count) + " events, scalar")) << count << false;
+        if (EventTimerNS::Timestamp::simdAvailable()){
+            QTest::newRow(qPrintable(QString::number(count) + " events, simd")) << count << true;
+        }
+    }
+}
+
+
+void EventBenchmark::batchSizes()
+{
+    QTest::addColumn<unsigned>("count");
+    QTest::newRow("1 event") << 1u;
+    QTest::newRow("1000 events") << 1000u;
+    QTest::newRow("100000 events") << 100000u;
+}
+
+
+QTEST_APPLESS_MAIN(EventBenchmark)
+
+#include "tst_eventbenchmark.moc"
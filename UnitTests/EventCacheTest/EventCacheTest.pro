@@ -0,0 +1,26 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_eventcachetest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+DEPENDPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+SOURCES += \
+    tst_eventcachetest.cc \
+    ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc \
+    ../../EventTimer/src/eventcache.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
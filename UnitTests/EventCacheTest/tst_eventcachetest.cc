@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::EventCache class.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include "eventcache.hh"
+
+/**
+ * @brief Unit tests for the EventTimerNS::EventCache class.
+ */
+class EventCacheTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    EventCacheTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test that least recently used event is discarded when the cache is full.
+     */
+    void evictionTest();
+
+    /**
+     * @brief Test replacing and rescheduling cached events.
+     */
+    void updateTest();
+
+    /**
+     * @brief Test removing events.
+     */
+    void removeTest();
+
+    /**
+     * @brief Test that cache with zero capacity stores nothing.
+     */
+    void disabledTest();
+
+    /**
+     * @brief Test that events read before a modification are not cached.
+     */
+    void generationTest();
+
+private:
+
+    EventTimerNS::Event makeEvent(unsigned id, EventTimerNS::Event::Type type = EventTimerNS::Event::DYNAMIC);
+};
+
+EventCacheTest::EventCacheTest()
+{
+}
+
+
+void EventCacheTest::evictionTest()
+{
+    EventTimerNS::EventCache cache(3);
+    cache.put(makeEvent(1));
+    cache.put(makeEvent(2));
+    cache.put(makeEvent(3));
+    QCOMPARE(cache.size(), 3u);
+
+    // Use event 1, so that 2 becomes the least recently used.
+    EventTimerNS::Event e;
+    QVERIFY(cache.find(1, &e));
+    QCOMPARE(e.id(), 1u);
+    cache.put(makeEvent(4));
+    QCOMPARE(cache.size(), 3u);
+    QVERIFY(!cache.contains(2));
+    QVERIFY(cache.contains(1));
+    QVERIFY(cache.contains(3));
+    QVERIFY(cache.find(4, &e));
+    QCOMPARE(e.name(), QString("event4"));
+}
+
+
+void EventCacheTest::updateTest()
+{
+    EventTimerNS::EventCache cache(2);
+    cache.put(makeEvent(1));
+
+    EventTimerNS::Event e = makeEvent(1);
+    e.setName("replaced");
+    cache.put(e);
+    QCOMPARE(cache.size(), 1u);
+    EventTimerNS::Event cached;
+    QVERIFY(cache.find(1, &cached));
+    QCOMPARE(cached.name(), QString("replaced"));
+
+    cache.reschedule(1, "2017-01-01 00:00:00:000", 500, 3);
+    QVERIFY(cache.find(1, &cached));
+    QCOMPARE(cached.timestamp(), QString("2017-01-01 00:00:00:000"));
+    QCOMPARE(cached.interval(), 500u);
+    QCOMPARE(cached.repeats(), 3u);
+    QCOMPARE(cached.name(), QString("replaced"));
+
+    // Rescheduling uncached event does nothing.
+    cache.reschedule(2, "2017-01-01 00:00:00:000", 500, 3);
+    QCOMPARE(cache.size(), 1u);
+}
+
+
+void EventCacheTest::removeTest()
+{
+    using EventTimerNS::Event;
+    EventTimerNS::EventCache cache(10);
+    for (unsigned i=1; i<=6; ++i){
+        cache.put(makeEvent(i, i%2 == 0 ? Event::STATIC : Event::DYNAMIC));
+    }
+
+    cache.remove(1);
+    cache.remove(100);
+    QCOMPARE(cache.size(), 5u);
+    QVERIFY(!cache.contains(1));
+
+    cache.removeType(Event::DYNAMIC);
+    QCOMPARE(cache.size(), 3u);
+    QVERIFY(!cache.contains(3));
+    QVERIFY(cache.contains(4));
+
+    cache.clear();
+    QCOMPARE(cache.size(), 0u);
+    QVERIFY(!cache.contains(4));
+}
+
+
+void EventCacheTest::disabledTest()
+{
+    EventTimerNS::EventCache cache(0);
+    cache.put(makeEvent(1));
+    QCOMPARE(cache.size(), 0u);
+    EventTimerNS::Event e;
+    QVERIFY(!cache.find(1, &e));
+}
+
+
+void EventCacheTest::generationTest()
+{
+    EventTimerNS::EventCache cache(10);
+    cache.put(makeEvent(1));
+
+    // Unchanged cache accepts the event.
+    quint64 generation = cache.generation();
+    cache.putIfUnchanged(makeEvent(2), generation);
+    QVERIFY(cache.contains(2));
+    QCOMPARE(cache.generation(), generation);
+
+    // Event read before a modification may be out of date.
+    generation = cache.generation();
+    cache.remove(1);
+    cache.putIfUnchanged(makeEvent(1), generation);
+    QVERIFY(!cache.contains(1));
+    QVERIFY(cache.generation() != generation);
+
+    // Update of an event that is not cached still rejects reads started before it.
+    generation = cache.generation();
+    EventTimerNS::Event e = makeEvent(3);
+    e.setName("updated");
+    cache.update(e);
+    QVERIFY(!cache.contains(3));
+    cache.putIfUnchanged(makeEvent(3), generation);
+    QVERIFY(!cache.contains(3));
+
+    // Update replaces cached event without changing its position.
+    e = makeEvent(2);
+    e.setName("updated");
+    cache.update(e);
+    QVERIFY(cache.find(2, &e));
+    QCOMPARE(e.name(), QString("updated"));
+
+    generation = cache.generation();
+    cache.invalidate();
+    cache.putIfUnchanged(makeEvent(3), generation);
+    QVERIFY(!cache.contains(3));
+}
+
+
+EventTimerNS::Event EventCacheTest::makeEvent(unsigned id, EventTimerNS::Event::Type type)
+{
+    EventTimerNS::Event e("event" + QString::number(id), "2016-01-01 00:00:00:000", type);
+    e.setId(id);
+    return e;
+}
+
+
+QTEST_APPLESS_MAIN(EventCacheTest)
+
+#include "tst_eventcachetest.moc"
@@ -23,6 +23,7 @@ DEPENDPATH += \
 
 SOURCES += \
     tst_eventtest.cc \
-    ../../EventTimer/src/event.cc
+    ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,29 @@
+QT       += sql testlib
+
+QT       -= gui
+
+TARGET = tst_eventtimercoretest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+DEPENDPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+SOURCES += \
+    tst_eventtimercoretest.cc \
+    ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc \
+    ../../EventTimer/src/eventbatch.cc \
+    ../../EventTimer/src/scheduleindex.cc \
+    ../../EventTimer/src/latencyhistogram.cc \
+    ../../EventTimer/src/tracerecorder.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
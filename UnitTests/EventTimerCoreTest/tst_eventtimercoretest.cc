@@ -0,0 +1,358 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::EventTimerCore class template.
+ *  Core is driven with a virtual clock and in-memory storage.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QStringList>
+#include <QtTest>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "eventtimercore.hh"
+#include "enginepolicies.hh"
+#include "timestamp.hh"
+
+
+namespace
+{
+
+// Storage policy keeping events in a map.
+class MemoryStorage
+{
+public:
+    MemoryStorage() : events(), failReschedule(false)
+    {
+    }
+
+    bool checkOccured(qint64 nowMsec, EventTimerNS::EventBatch* batch)
+    {
+        std::vector<std::pair<qint64, unsigned> > due;
+        for (const auto& entry : events){
+            qint64 msec = 0;
+            if (EventTimerNS::Timestamp::parse(entry.second.timestamp(), &msec) && msec < nowMsec){
+                due.push_back(std::make_pair(msec, entry.first));
+            }
+        }
+        std::sort(due.begin(), due.end());
+
+        batch->clear();
+        for (const auto& entry : due){
+            *batch->append() = events[entry.second];
+        }
+        batch->decodeDueTimes();
+        return true;
+    }
+
+    bool rescheduleEvents(const std::vector<unsigned>& eventIds, qint64 dueMsec,
+                          unsigned interval, unsigned repeats)
+    {
+        if (failReschedule) return false;
+        for (unsigned id : eventIds){
+            EventTimerNS::Event& e = events[id];
+            e.setTimestamp(EventTimerNS::Timestamp::format(dueMsec));
+            e.setInterval(interval);
+            e.setRepeats(repeats);
+        }
+        return true;
+    }
+
+    bool removeEvents(const std::vector<unsigned>& eventIds)
+    {
+        for (unsigned id : eventIds){
+            events.erase(id);
+        }
+        return true;
+    }
+
+    QString errorString() const
+    {
+        return "storage error";
+    }
+
+    std::map<unsigned, EventTimerNS::Event> events;
+    bool failReschedule;
+};
+
+
+// Dispatch policy recording notified event ids.
+class RecordingDispatch
+{
+public:
+    void notify(const EventTimerNS::Event& e)
+    {
+        ids.push_back(e.id());
+    }
+
+    std::vector<unsigned> ids;
+};
+
+
+class LoggerStub : public EventTimerNS::Logger
+{
+public:
+    void logMsg(const QString& msg)
+    {
+        messages.append(msg);
+    }
+
+    QStringList messages;
+};
+
+
+typedef EventTimerNS::EventTimerCore<EventTimerNS::VirtualClock, MemoryStorage, RecordingDispatch> TestCore;
+
+} // Anonymous namespace
+
+
+/**
+ * @brief Unit tests for the EventTimerNS::EventTimerCore class template.
+ */
+class EventTimerCoreTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    EventTimerCoreTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Resolve base time of the tests.
+     */
+    void initTestCase();
+
+    /**
+     * @brief Test that events fire only after their due time and lateness is recorded.
+     */
+    void fireTest();
+
+    /**
+     * @brief Test rescheduling and removing a repeating event.
+     */
+    void repeatTest();
+
+    /**
+     * @brief Test that missed occurences are skipped.
+     */
+    void skipTest();
+
+    /**
+     * @brief Test that failed reschedule is logged and retried later.
+     */
+    void failureTest();
+
+    /**
+     * @brief Test that stored event with repeats but no interval is removed.
+     */
+    void zeroIntervalTest();
+
+    /**
+     * @brief Test that ticks after the first reuse the storage of the expired batch.
+     */
+    void batchReuseTest();
+
+private:
+
+    qint64 base_;
+
+    // Add event due at base_ + offset to storage and schedule.
+    void addEvent(TestCore* core, unsigned id, qint64 offset, unsigned interval = 0, unsigned repeats = 0);
+};
+
+
+EventTimerCoreTest::EventTimerCoreTest() : base_(0)
+{
+}
+
+
+void EventTimerCoreTest::initTestCase()
+{
+    QVERIFY(EventTimerNS::Timestamp::parse("2016-01-01 12:00:00:000", &base_));
+}
+
+
+void EventTimerCoreTest::addEvent(TestCore* core, unsigned id, qint64 offset, unsigned interval, unsigned repeats)
+{
+    EventTimerNS::Event e("event" + QString::number(id), EventTimerNS::Timestamp::format(base_ + offset),
+                          EventTimerNS::Event::DYNAMIC, interval, repeats);
+    e.setId(id);
+    core->storage().events[id] = e;
+    core->schedule().insert(id, base_ + offset);
+}
+
+
+void EventTimerCoreTest::fireTest()
+{
+    using namespace EventTimerNS;
+    TestCore core(VirtualClock(base_), MemoryStorage(), RecordingDispatch());
+    this->addEvent(&core, 2, 100);
+    this->addEvent(&core, 1, 100);
+    this->addEvent(&core, 3, 200);
+
+    // Events fire after, not at, their due time.
+    EventBatch expired;
+    core.clock().advance(100);
+    core.check(&expired);
+    QVERIFY(core.dispatch().ids.empty());
+
+    core.clock().advance(30);
+    core.check(&expired);
+    QCOMPARE(core.dispatch().ids, std::vector<unsigned>({1, 2}));
+    QCOMPARE(core.counters().eventsFired.value(), quint64(2));
+    QCOMPARE(core.counters().eventsRemoved.value(), quint64(2));
+    QCOMPARE(core.lateness().count(), quint64(2));
+    QCOMPARE(core.lateness().max(), qint64(30));
+    QCOMPARE(core.schedule().size(), 1u);
+    QCOMPARE(core.storage().events.size(), std::size_t(1));
+
+    core.clock().advance(100);
+    core.check(&expired);
+    QCOMPARE(core.dispatch().ids, std::vector<unsigned>({1, 2, 3}));
+    QVERIFY(core.schedule().empty());
+    QVERIFY(core.storage().events.empty());
+}
+
+
+void EventTimerCoreTest::repeatTest()
+{
+    using namespace EventTimerNS;
+    TestCore core(VirtualClock(base_), MemoryStorage(), RecordingDispatch());
+    this->addEvent(&core, 1, 0, 100, 2);
+
+    EventBatch expired;
+    for (unsigned i = 0; i < 2; ++i){
+        core.clock().advance(i == 0 ? 1 : 100);
+        core.check(&expired);
+        QCOMPARE(core.dispatch().ids.size(), std::size_t(i + 1));
+        QCOMPARE(core.schedule().earliest(), base_ + 100 * (i + 1));
+        QCOMPARE(core.storage().events[1].repeats(), 1 - i);
+    }
+
+    core.clock().advance(100);
+    core.check(&expired);
+    QCOMPARE(core.counters().eventsFired.value(), quint64(3));
+    QCOMPARE(core.counters().eventsRescheduled.value(), quint64(2));
+    QCOMPARE(core.counters().eventsRemoved.value(), quint64(1));
+    QVERIFY(core.schedule().empty());
+    QVERIFY(core.storage().events.empty());
+}
+
+
+void EventTimerCoreTest::skipTest()
+{
+    using namespace EventTimerNS;
+    TestCore core(VirtualClock(base_), MemoryStorage(), RecordingDispatch());
+    this->addEvent(&core, 1, 0, 100, Event::INFINITE_REPEAT);
+    this->addEvent(&core, 2, 0, 100, 5);
+    this->addEvent(&core, 3, 0, 100, 3);
+
+    // Occurences at 100...400 are missed. Event is fired once and moved to 500.
+    EventBatch expired;
+    core.clock().advance(450);
+    core.check(&expired);
+    QCOMPARE(core.dispatch().ids, std::vector<unsigned>({1, 2, 3}));
+    QCOMPARE(core.lateness().max(), qint64(450));
+
+    QCOMPARE(core.schedule().range(base_ + 500, base_ + 501, 10), std::vector<unsigned>({1, 2}));
+    QCOMPARE(core.storage().events[1].timestamp(), Timestamp::format(base_ + 500));
+    QCOMPARE(core.storage().events[1].repeats(), unsigned(Event::INFINITE_REPEAT));
+    QCOMPARE(core.storage().events[2].timestamp(), Timestamp::format(base_ + 500));
+    QCOMPARE(core.storage().events[2].repeats(), 0u);
+
+    // Last repeat of event 3 was missed.
+    QVERIFY(!core.schedule().contains(3));
+    QCOMPARE(core.storage().events.count(3), std::size_t(0));
+}
+
+
+void EventTimerCoreTest::failureTest()
+{
+    using namespace EventTimerNS;
+    TestCore core(VirtualClock(base_), MemoryStorage(), RecordingDispatch());
+    LoggerStub logger;
+    core.setLogger(&logger);
+    core.storage().failReschedule = true;
+    this->addEvent(&core, 1, 0, 100, Event::INFINITE_REPEAT);
+
+    EventBatch expired;
+    core.clock().advance(10);
+    core.check(&expired);
+    QCOMPARE(core.dispatch().ids.size(), std::size_t(1));
+    QCOMPARE(core.counters().eventsRescheduled.value(), quint64(0));
+    QCOMPARE(logger.messages.size(), 1);
+    QVERIFY(logger.messages.at(0).contains("storage error"));
+
+    // Event stays indexed, so that a timer is armed to retry it.
+    QCOMPARE(core.schedule().size(), 1u);
+    QCOMPARE(core.schedule().earliest(), core.clock().nowMsec() + TestCore::RETRY_DELAY_MSEC);
+
+    // Event is retried on next check.
+    core.storage().failReschedule = false;
+    core.clock().advance(TestCore::RETRY_DELAY_MSEC);
+    core.check(&expired);
+    QCOMPARE(core.dispatch().ids.size(), std::size_t(2));
+    QCOMPARE(core.counters().eventsRescheduled.value(), quint64(1));
+    QVERIFY(!core.schedule().empty());
+}
+
+
+void EventTimerCoreTest::zeroIntervalTest()
+{
+    using namespace EventTimerNS;
+    TestCore core(VirtualClock(base_), MemoryStorage(), RecordingDispatch());
+    this->addEvent(&core, 1, 0);
+    core.storage().events[1].setRepeats(3);
+
+    EventBatch expired;
+    core.clock().advance(10);
+    core.check(&expired);
+    QCOMPARE(core.dispatch().ids, std::vector<unsigned>({1}));
+    QCOMPARE(core.counters().eventsRemoved.value(), quint64(1));
+    QVERIFY(core.schedule().empty());
+    QVERIFY(core.storage().events.empty());
+}
+
+
+void EventTimerCoreTest::batchReuseTest()
+{
+    using namespace EventTimerNS;
+    TestCore core(VirtualClock(base_), MemoryStorage(), RecordingDispatch());
+    const unsigned count = 100;
+    for (unsigned id = 1; id <= count; ++id){
+        this->addEvent(&core, id, 0, 100, Event::INFINITE_REPEAT);
+    }
+
+    // Every event expires on every tick, as checkEvents of a running timer sees them.
+    EventBatch expired;
+    core.clock().advance(10);
+    core.check(&expired);
+    QCOMPARE(expired.size(), count);
+    const Event* storage = &expired.at(0);
+
+    for (unsigned tick = 2; tick <= 5; ++tick){
+        core.clock().advance(100);
+        core.check(&expired);
+        QCOMPARE(expired.size(), count);
+        QVERIFY(&expired.at(0) == storage);
+        QCOMPARE(core.dispatch().ids.size(), std::size_t(tick * count));
+    }
+
+    // Smaller tick fits into the same storage.
+    for (unsigned id = 1; id <= count / 2; ++id){
+        core.storage().events.erase(id);
+        core.schedule().remove(id);
+    }
+    core.clock().advance(100);
+    core.check(&expired);
+    QCOMPARE(expired.size(), count / 2);
+    QVERIFY(&expired.at(0) == storage);
+    QCOMPARE(core.counters().eventsRescheduled.value(), quint64(6 * count - count / 2));
+}
+
+
+QTEST_APPLESS_MAIN(EventTimerCoreTest)
+
+#include "tst_eventtimercoretest.moc"
@@ -0,0 +1,41 @@
+QT       += sql testlib
+
+QT       -= gui
+
+TARGET = tst_eventtimerlogicbenchmark
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+DEPENDPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+HEADERS += \
+    ../../EventTimer/src/eventtimerlogic.hh
+
+SOURCES += \
+    tst_eventtimerlogicbenchmark.cc \
+    ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc \
+    ../../EventTimer/src/eventtimerlogic.cc \
+    ../../EventTimer/src/databasehandler.cc \
+    ../../EventTimer/src/eventtimerbuilder.cc \
+    ../../EventTimer/src/latencyhistogram.cc \
+    ../../EventTimer/src/scheduleindex.cc \
+    ../../EventTimer/src/eventcache.cc \
+    ../../EventTimer/src/namepool.cc \
+    ../../EventTimer/src/eventbatch.cc \
+    ../../EventTimer/src/databaseprofile.cc \
+    ../../EventTimer/src/tracerecorder.cc \
+    ../../EventTimer/src/snapshot.cc \
+    ../../EventTimer/src/schedulepublisher.cc \
+    ../../EventTimer/src/scheduleview.cc
+
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,291 @@
+/**
+ * @file
+ * @brief Benchmarking tests for the whole schedule, check, update and notify
+ *  path of timers created with EventTimerBuilder.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include <QEventLoop>
+#include <QTimer>
+#include <memory>
+#include "eventtimerbuilder.hh"
+
+
+/**
+ * @brief EventHandler that counts notifications and stops an event loop
+ *  when the expected number of events has fired.
+ */
+class RecordingHandler : public EventTimerNS::EventHandler
+{
+public:
+
+    RecordingHandler() : fired(0), target(0), loop(nullptr)
+    {
+    }
+
+    void notify(const EventTimerNS::Event&)
+    {
+        if (++fired == target && loop != nullptr){
+            loop->quit();
+        }
+    }
+
+    quint64 fired;
+    quint64 target;
+    QEventLoop* loop;
+};
+
+
+/**
+ * @brief The EventTimerLogicBenchmark class measures firing throughput,
+ *  check duration and lateness of a running EventTimer. Each scenario has a row
+ *  reporting throughput (events per second, as QTest::FramesPerSecond) and a row
+ *  reporting p99 lateness (as QTest::WalltimeMilliseconds), because QTest
+ *  stores one benchmark result per row.
+ */
+class EventTimerLogicBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    EventTimerLogicBenchmark();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Benchmark firing a burst of single-shot events due within a time window.
+     */
+    void burstBenchmark();
+    void burstBenchmark_data();
+
+    /**
+     * @brief Benchmark firing repeating events continuously for a fixed time.
+     */
+    void sustainedBenchmark();
+    void sustainedBenchmark_data();
+
+private:
+
+    // Create timer for the current data row. Table is emptied.
+    std::shared_ptr<EventTimerNS::EventTimer> createTimer(int refreshRate, RecordingHandler* handler);
+
+    // Print throughput, check duration and lateness statistics. Events per second
+    // or p99 lateness, if measureLateness is true, is set as the benchmark result.
+    void report(EventTimerNS::EventTimer* timer, quint64 fired, qint64 elapsedMsec, bool measureLateness);
+
+    // Add throughput and lateness rows of a scenario. Caller appends the scenario's data to both rows.
+    static QTestData& throughputRow(const QString& scenario);
+    static QTestData& latenessRow(const QString& scenario);
+
+    // Delay before the first event, so that all events are added before they are due.
+    static const int START_DELAY_MSEC_;
+
+    // Duration of the sustained firing benchmark.
+    static const int RUN_TIME_MSEC_;
+
+    // Upper limit for waiting a burst to fire.
+    static const int TIMEOUT_MSEC_;
+};
+
+
+const int EventTimerLogicBenchmark::START_DELAY_MSEC_(2000);
+const int EventTimerLogicBenchmark::RUN_TIME_MSEC_(3000);
+const int EventTimerLogicBenchmark::TIMEOUT_MSEC_(60000);
+
+
+EventTimerLogicBenchmark::EventTimerLogicBenchmark()
+{
+}
+
+
+void EventTimerLogicBenchmark::burstBenchmark()
+{
+    QFETCH(unsigned, count);
+    QFETCH(int, spreadMsec);
+    QFETCH(int, refreshRate);
+    QFETCH(bool, measureLateness);
+
+    using namespace EventTimerNS;
+    RecordingHandler handler;
+    std::shared_ptr<EventTimer> timer = this->createTimer(refreshRate, &handler);
+
+    // Events are spread evenly across the window (all due at once if spread is 0).
+    QDateTime first = QDateTime::currentDateTime().addMSecs(START_DELAY_MSEC_);
+    for (unsigned i=0; i<count; ++i){
+        qint64 offset = qint64(spreadMsec) * i / count;
+        Event e("burst" + QString::number(i%100), first.addMSecs(offset).toString(Event::TIME_FORMAT),
+                Event::STATIC);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+    if (QDateTime::currentDateTime() >= first){
+        QSKIP("Adding events took longer than the start delay.");
+    }
+
+    QEventLoop loop;
+    handler.loop = &loop;
+    handler.target = count;
+    QTimer::singleShot(TIMEOUT_MSEC_, &loop, SLOT(quit()));
+
+    timer->start();
+    loop.exec();
+    timer->stop();
+
+    // Throughput is measured from the first due time.
+    QCOMPARE(handler.fired, quint64(count));
+    this->report(timer.get(), handler.fired, first.msecsTo(QDateTime::currentDateTime()), measureLateness);
+    QVERIFY(timer->clearAll());
+}
+
+
+void EventTimerLogicBenchmark::burstBenchmark_data()
+{
+    QTest::addColumn<unsigned>("count");
+    QTest::addColumn<int>("spreadMsec");
+    QTest::addColumn<int>("refreshRate");
+    QTest::addColumn<bool>("measureLateness");
+
+    struct Scenario { const char* name; unsigned count; int spreadMsec; int refreshRate; };
+    const Scenario scenarios[] = {
+        {"100 events at once, refresh 0", 100, 0, 0},
+        {"100 events at once, polling 100ms", 100, 0, 100},
+        {"1000 events at once, refresh 0", 1000, 0, 0},
+        {"1000 events at once, polling 100ms", 1000, 0, 100},
+        {"1000 events in 1s, refresh 0", 1000, 1000, 0},
+        {"1000 events in 1s, polling 100ms", 1000, 1000, 100},
+        {"10000 events in 1s, refresh 0", 10000, 1000, 0},
+        {"10000 events in 1s, polling 100ms", 10000, 1000, 100}
+    };
+    for (const Scenario& s : scenarios){
+        throughputRow(s.name) << s.count << s.spreadMsec << s.refreshRate << false;
+        latenessRow(s.name) << s.count << s.spreadMsec << s.refreshRate << true;
+    }
+}
+
+
+void EventTimerLogicBenchmark::sustainedBenchmark()
+{
+    QFETCH(unsigned, count);
+    QFETCH(unsigned, interval);
+    QFETCH(int, refreshRate);
+    QFETCH(bool, measureLateness);
+
+    using namespace EventTimerNS;
+    RecordingHandler handler;
+    std::shared_ptr<EventTimer> timer = this->createTimer(refreshRate, &handler);
+
+    // Phases are spread evenly across the interval, so events fire at a steady rate.
+    QDateTime first = QDateTime::currentDateTime().addMSecs(START_DELAY_MSEC_);
+    for (unsigned i=0; i<count; ++i){
+        qint64 phase = qint64(interval) * i / count;
+        Event e("repeating" + QString::number(i%100), first.addMSecs(phase).toString(Event::TIME_FORMAT),
+                Event::STATIC, interval, Event::INFINITE_REPEAT);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+
+    if (QDateTime::currentDateTime() >= first){
+        QSKIP("Adding events took longer than the start delay.");
+    }
+
+    QEventLoop loop;
+    QTimer::singleShot(QDateTime::currentDateTime().msecsTo(first) + RUN_TIME_MSEC_, &loop, SLOT(quit()));
+    timer->start();
+    loop.exec();
+    timer->stop();
+
+    // Expected rate is count events per interval.
+    double expected = double(count) * RUN_TIME_MSEC_ / interval;
+    qDebug() << "Expected about" << qint64(expected) << "events.";
+    QVERIFY(handler.fired > 0);
+    this->report(timer.get(), handler.fired, first.msecsTo(QDateTime::currentDateTime()), measureLateness);
+    QVERIFY(timer->clearAll());
+}
+
+
+void EventTimerLogicBenchmark::sustainedBenchmark_data()
+{
+    QTest::addColumn<unsigned>("count");
+    QTest::addColumn<unsigned>("interval");
+    QTest::addColumn<int>("refreshRate");
+    QTest::addColumn<bool>("measureLateness");
+
+    struct Scenario { const char* name; unsigned count; unsigned interval; int refreshRate; };
+    const Scenario scenarios[] = {
+        {"100 events every 1s, refresh 0", 100, 1000, 0},
+        {"100 events every 1s, polling 100ms", 100, 1000, 100},
+        {"1000 events every 1s, refresh 0", 1000, 1000, 0},
+        {"1000 events every 1s, polling 100ms", 1000, 1000, 100},
+        {"10000 events every 1s, refresh 0", 10000, 1000, 0},
+        {"10000 events every 1s, polling 100ms", 10000, 1000, 100}
+    };
+    for (const Scenario& s : scenarios){
+        throughputRow(s.name) << s.count << s.interval << s.refreshRate << false;
+        latenessRow(s.name) << s.count << s.interval << s.refreshRate << true;
+    }
+}
+
+
+std::shared_ptr<EventTimerNS::EventTimer>
+EventTimerLogicBenchmark::createTimer(int refreshRate, RecordingHandler* handler)
+{
+    using namespace EventTimerNS;
+    EventTimerBuilder::Configuration conf;
+    conf.dbType = "QSQLITE";
+    conf.dbName = "SQLiteLogicBenchmarkDB";
+    conf.tableName = "events";
+    conf.refreshRateMsec = refreshRate;
+    conf.databaseProfile = DatabaseProfile::balanced();
+
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    Q_ASSERT(timer->isValid());
+    timer->clearAll();
+    timer->setEventHandler(handler);
+    return timer;
+}
+
+
+void EventTimerLogicBenchmark::report(EventTimerNS::EventTimer* timer, quint64 fired, qint64 elapsedMsec,
+                                      bool measureLateness)
+{
+    EventTimerNS::EventTimer::Statistics s = timer->stats();
+    EventTimerNS::LatencyHistogram lateness = timer->firingLateness();
+    elapsedMsec = qMax(qint64(1), elapsedMsec);
+
+    qDebug() << "Fired" << fired << "events in" << elapsedMsec << "ms:"
+             << qint64(fired * 1000.0 / elapsedMsec) << "events/s.";
+    if (s.checks != 0){
+        qDebug() << "Checks:" << s.checks << "mean duration (us):" << s.checkTimeNsec / s.checks / 1000;
+    }
+    if (fired != 0){
+        qDebug() << "Database time per event (us):" << s.databaseTimeNsec / fired / 1000
+                 << "handler time per event (us):" << s.handlerTimeNsec / fired / 1000;
+    }
+    qDebug() << "Lateness (ms): p50" << lateness.percentile(50) << "p99" << lateness.percentile(99)
+             << "max" << lateness.max();
+
+    // Results are read by BenchmarkCompare from the XML output.
+    if (measureLateness){
+        QTest::setBenchmarkResult(lateness.count() == 0 ? 0 : lateness.percentile(99),
+                                  QTest::WalltimeMilliseconds);
+    } else {
+        QTest::setBenchmarkResult(fired * 1000.0 / elapsedMsec, QTest::FramesPerSecond);
+    }
+}
+
+
+QTestData& EventTimerLogicBenchmark::throughputRow(const QString& scenario)
+{
+    return QTest::newRow(qPrintable(scenario + ", events/s"));
+}
+
+
+QTestData& EventTimerLogicBenchmark::latenessRow(const QString& scenario)
+{
+    return QTest::newRow(qPrintable(scenario + ", p99 lateness"));
+}
+
+
+QTEST_GUILESS_MAIN(EventTimerLogicBenchmark)
+
+#include "tst_eventtimerlogicbenchmark.moc"
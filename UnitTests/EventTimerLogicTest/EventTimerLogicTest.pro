@@ -28,9 +28,20 @@ HEADERS += \
 SOURCES += \
     tst_eventtimerlogictest.cc \
     ../../EventTimer/src/event.cc \
+    ../../EventTimer/src/timestamp.cc \
     ../../EventTimer/src/eventtimerlogic.cc \
     ../../EventTimer/src/databasehandler.cc \
-    ../../EventTimer/src/eventtimerbuilder.cc
+    ../../EventTimer/src/eventtimerbuilder.cc \
+    ../../EventTimer/src/latencyhistogram.cc \
+    ../../EventTimer/src/scheduleindex.cc \
+    ../../EventTimer/src/eventcache.cc \
+    ../../EventTimer/src/namepool.cc \
+    ../../EventTimer/src/eventbatch.cc \
+    ../../EventTimer/src/databaseprofile.cc \
+    ../../EventTimer/src/tracerecorder.cc \
+    ../../EventTimer/src/snapshot.cc \
+    ../../EventTimer/src/schedulepublisher.cc \
+    ../../EventTimer/src/scheduleview.cc
 
 
 DEFINES += SRCDIR=\\\"$$PWD/\\\"
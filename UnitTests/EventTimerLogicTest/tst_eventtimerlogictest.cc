@@ -7,8 +7,12 @@
 
 #include <QString>
 #include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
 #include <memory>
+#include <algorithm>
 #include "eventtimerbuilder.hh"
+#include "scheduleview.hh"
 
 Q_DECLARE_METATYPE(EventTimerNS::EventTimerBuilder::Configuration)
 
@@ -29,6 +33,35 @@ public:
 };
 
 
+/**
+ * @brief Logger stub accepting only messages of level LEVEL_WARNING or higher.
+ */
+class WarningLoggerStub : public EventTimerNS::Logger
+{
+public:
+
+    QStringList messages;
+    std::vector<Level> levels;
+
+    void logMsg(const QString& msg)
+    {
+        messages.push_back(msg);
+    }
+
+    bool isEnabled(Level level) const
+    {
+        return level >= LEVEL_WARNING;
+    }
+
+    void log(Level level, const QString& msg)
+    {
+        QVERIFY(this->isEnabled(level));
+        levels.push_back(level);
+        this->logMsg(msg);
+    }
+};
+
+
 /**
  * @brief Stub implementation for the EventHandler interface.
  */
@@ -45,6 +78,24 @@ public:
 };
 
 
+/**
+ * @brief EventHandler implementation that records firing lateness
+ *  (notification time - event timestamp) in milliseconds.
+ */
+class LatenessRecorder : public EventTimerNS::EventHandler
+{
+public:
+
+    std::vector<qint64> lateness;
+
+    void notify(const EventTimerNS::Event& event)
+    {
+        QDateTime scheduled = QDateTime::fromString(event.timestamp(), EventTimerNS::Event::TIME_FORMAT);
+        lateness.push_back(scheduled.msecsTo(QDateTime::currentDateTime()));
+    }
+};
+
+
 /**
  * @brief Unit tests for the EventTimerLogic and EventTimerBuilder classes.
  */
@@ -81,6 +132,30 @@ private Q_SLOTS:
     void removeEvent();
     void removeEvent_data();
 
+    /**
+     * @brief Test removing multiple events at once.
+     */
+    void removeEventsTest();
+    void removeEventsTest_data();
+
+    /**
+     * @brief Test rescheduling event in place.
+     */
+    void rescheduleEventTest();
+    void rescheduleEventTest_data();
+
+    /**
+     * @brief Test paging through events within a time range.
+     */
+    void eventsBetweenTest();
+    void eventsBetweenTest_data();
+
+    /**
+     * @brief Test paging through events due before 1970.
+     */
+    void eventsBetweenBefore1970Test();
+    void eventsBetweenBefore1970Test_data();
+
     /**
      * @brief Test getting next events.
      */
@@ -112,6 +187,59 @@ private Q_SLOTS:
     void startNotifyPolicyTest();
     void startNotifyPolicyTest_data();
 
+    /**
+     * @brief Measure firing lateness percentiles of events scheduled while the timer is running.
+     */
+    void firingLatenessTest();
+    void firingLatenessTest_data();
+
+    /**
+     * @brief Verify that adaptive timer fires events on time despite a long refresh rate.
+     */
+    void adaptiveRefreshTest();
+    void adaptiveRefreshTest_data();
+
+    /**
+     * @brief Verify that events within the slack window are fired in the same tick.
+     */
+    void coalesceSlackTest();
+    void coalesceSlackTest_data();
+
+    /**
+     * @brief Test runtime statistics counters.
+     */
+    void statsTest();
+    void statsTest_data();
+
+    /**
+     * @brief Test that events due at the same time are rescheduled and removed as groups.
+     */
+    void groupFiringTest();
+    void groupFiringTest_data();
+
+    /**
+     * @brief Test that messages below logger's level are not passed to logger.
+     */
+    void logLevelFilterTest();
+    void logLevelFilterTest_data();
+
+    /**
+     * @brief Test that timer operations are recorded into the trace recorder.
+     */
+    void traceTest();
+    void traceTest_data();
+
+    /**
+     * @brief Test that schedule changes are published into the shared-memory schedule view.
+     */
+    void scheduleViewTest();
+    void scheduleViewTest_data();
+
+    /**
+     * @brief Test that schedule is not published, if it could not be loaded from the database.
+     */
+    void scheduleViewNotLoadedTest();
+
 
 private:
 
@@ -267,6 +395,193 @@ void EventTimerLogicTest::removeEvent_data()
 }
 
 
+void EventTimerLogicTest::removeEventsTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    LoggerStub logger;
+    HandlerStub handler;
+    timer->clearAll();
+    timer->setEventHandler(&handler);
+    timer->start();
+
+    // Dynamic events are added after start, which clears them.
+    QDateTime current = QDateTime::currentDateTime();
+    std::vector<unsigned> ids;
+    for (int i=0; i<10; ++i){
+        Event e("name" + QString::number(i), current.addSecs(60+i).toString(Event::TIME_FORMAT),
+                Event::DYNAMIC);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+        ids.push_back(e.id());
+    }
+    timer->setLogger(&logger);
+
+    // Remove all but the last event. Unknown id is not counted as removed.
+    unsigned kept = ids.back();
+    ids.pop_back();
+    ids.push_back(kept + 1000);
+    QVERIFY(timer->removeEvents(ids));
+    QVERIFY(timer->isValid());
+    QVERIFY(timer->errorString().isEmpty());
+    QCOMPARE(logger.messages.size(), QStringList::size_type(1));
+    qDebug() << logger.messages.at(0);
+    QCOMPARE(timer->stats().eventsRemoved, quint64(9));
+
+    std::vector<Event> next = timer->nextEvents(10);
+    QCOMPARE(next.size(), std::vector<Event>::size_type(1));
+    QCOMPARE(next.at(0).id(), kept);
+    QCOMPARE(handler.events.size(), std::vector<Event>::size_type(0));
+    timer->stop();
+}
+
+
+void EventTimerLogicTest::removeEventsTest_data()
+{
+    invalidBuildetTest_data();
+}
+
+
+void EventTimerLogicTest::rescheduleEventTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    LoggerStub logger;
+    HandlerStub handler;
+    timer->clearAll();
+    timer->setEventHandler(&handler);
+    timer->start();
+
+    QDateTime current = QDateTime::currentDateTime();
+    Event e("name", current.addDays(1).toString(Event::TIME_FORMAT), Event::DYNAMIC);
+    unsigned id = timer->addEvent(&e);
+    QVERIFY(id != Event::UNASSIGNED_ID);
+    // Repeats without interval are rejected.
+    QVERIFY(!timer->rescheduleEvent(id, current.addMSecs(100).toString(Event::TIME_FORMAT), 0, 3));
+    QVERIFY(!timer->errorString().isEmpty());
+    QCOMPARE(timer->getEvent(id).timestamp(), e.timestamp());
+    QVERIFY(timer->isValid());
+    timer->setLogger(&logger);
+
+    // Move event close. Timer must be re-armed to fire it.
+    QString timestamp = QDateTime::currentDateTime().addMSecs(100).toString(Event::TIME_FORMAT);
+    QVERIFY(timer->rescheduleEvent(id, timestamp, 0, 0));
+    QCOMPARE(logger.messages.size(), QStringList::size_type(1));
+    qDebug() << logger.messages.at(0);
+    Event tmp = timer->getEvent(id);
+    QCOMPARE(tmp.id(), id);
+    QCOMPARE(tmp.name(), QString("name"));
+    QCOMPARE(tmp.timestamp(), timestamp);
+
+    QTRY_COMPARE_WITH_TIMEOUT(handler.events.size(), std::vector<Event>::size_type(1), 5000);
+    QCOMPARE(handler.events.at(0).id(), id);
+
+    // Event has been removed after firing.
+    QVERIFY(!timer->rescheduleEvent(id, timestamp, 0, 0));
+    QVERIFY(!timer->errorString().isEmpty());
+    QVERIFY(timer->isValid());
+    timer->stop();
+}
+
+
+void EventTimerLogicTest::rescheduleEventTest_data()
+{
+    statsTest_data();
+}
+
+
+void EventTimerLogicTest::eventsBetweenTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    HandlerStub handler;
+    timer->clearAll();
+    timer->setEventHandler(&handler);
+
+    QDateTime start = QDateTime::currentDateTime().addDays(1);
+    std::vector<Event> events;
+    for (int i=0; i<10; ++i){
+        Event e("name" + QString::number(i), start.addSecs(i/2).toString(Event::TIME_FORMAT),
+                Event::STATIC);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+        events.push_back(e);
+    }
+
+    // Page through all but the last second.
+    QString from = start.toString(Event::TIME_FORMAT);
+    QString to = start.addSecs(4).toString(Event::TIME_FORMAT);
+    std::vector<Event> received;
+    std::vector<Event> page = timer->eventsBetween(from, to, 3);
+    while (!page.empty()){
+        received.insert(received.end(), page.begin(), page.end());
+        page = timer->eventsBetween(from, to, 3, page.back());
+    }
+    QVERIFY(timer->errorString().isEmpty());
+
+    QCOMPARE(received.size(), std::vector<Event>::size_type(8));
+    for (unsigned i=0; i<received.size(); ++i){
+        this->compareEvents(received[i], events[i]);
+    }
+    QVERIFY(timer->clearAll());
+}
+
+
+void EventTimerLogicTest::eventsBetweenTest_data()
+{
+    invalidBuildetTest_data();
+}
+
+
+void EventTimerLogicTest::eventsBetweenBefore1970Test()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    HandlerStub handler;
+    timer->clearAll();
+    timer->setEventHandler(&handler);
+
+    // Timer is not started, so that expired events stay in the schedule.
+    QDateTime start = QDateTime::fromString("1969-06-01 12:00:00:000", Event::TIME_FORMAT);
+    QVERIFY(start.isValid());
+    std::vector<Event> events;
+    for (int i=0; i<10; ++i){
+        Event e("name" + QString::number(i), start.addSecs(i/2).toString(Event::TIME_FORMAT),
+                Event::STATIC);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+        events.push_back(e);
+    }
+
+    QString from = start.toString(Event::TIME_FORMAT);
+    QString to = start.addSecs(5).toString(Event::TIME_FORMAT);
+    std::vector<Event> received;
+    std::vector<Event> page = timer->eventsBetween(from, to, 3);
+    while (!page.empty() && received.size() <= events.size()){
+        received.insert(received.end(), page.begin(), page.end());
+        page = timer->eventsBetween(from, to, 3, page.back());
+    }
+    QVERIFY(timer->errorString().isEmpty());
+
+    QCOMPARE(received.size(), events.size());
+    for (unsigned i=0; i<received.size(); ++i){
+        this->compareEvents(received[i], events[i]);
+    }
+    QVERIFY(timer->clearAll());
+}
+
+
+void EventTimerLogicTest::eventsBetweenBefore1970Test_data()
+{
+    invalidBuildetTest_data();
+}
+
+
 void EventTimerLogicTest::nextEventsTest()
 {
     QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
@@ -525,6 +840,461 @@ void EventTimerLogicTest::startNotifyPolicyTest_data()
 }
 
 
+void EventTimerLogicTest::firingLatenessTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer (EventTimerBuilder::create(conf));
+    LatenessRecorder handler;
+    timer->clearAll();
+    timer->setEventHandler(&handler);
+    timer->start();
+
+    // Add single-shot events at irregular intervals.
+    const unsigned EVENT_COUNT = 40;
+    QDateTime first = QDateTime::currentDateTime().addMSecs(200);
+    for (unsigned i=0; i<EVENT_COUNT; ++i){
+        Event e("lateness"+QString::number(i),
+                first.addMSecs(i*37).toString(Event::TIME_FORMAT),
+                Event::DYNAMIC);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(handler.lateness.size(),
+                              std::vector<qint64>::size_type(EVENT_COUNT), 10000);
+    timer->stop();
+
+    // Timer's own lateness statistics.
+    LatencyHistogram stats = timer->firingLateness();
+    QCOMPARE(stats.count(), quint64(EVENT_COUNT));
+    qDebug() << "Timer statistics (ms): p50" << stats.percentile(50)
+             << "p99" << stats.percentile(99) << "p999" << stats.percentile(99.9)
+             << "max" << stats.max();
+
+    std::vector<qint64> l = handler.lateness;
+    std::sort(l.begin(), l.end());
+    qint64 p50 = l.at(l.size()/2);
+    qint64 p90 = l.at(l.size()*9/10);
+    qint64 p99 = l.at(l.size()*99/100);
+    qDebug() << "Lateness (ms): min" << l.front() << "p50" << p50
+             << "p90" << p90 << "p99" << p99 << "max" << l.back();
+
+    // Events never fire before their timestamp.
+    QVERIFY(l.front() >= 0);
+    QVERIFY(p50 <= 50);
+}
+
+
+void EventTimerLogicTest::firingLatenessTest_data()
+{
+    QTest::addColumn<EventTimerNS::EventTimerBuilder::Configuration>("conf");
+
+    EventTimerNS::EventTimerBuilder::Configuration conf;
+    conf.dbType = "QSQLITE";
+    conf.dbName = "SQLiteTestDB";
+    conf.tableName = "events";
+    conf.refreshRateMsec = 0;
+
+    conf.preciseTimer = false;
+    QTest::newRow("Local SQLite, refresh rate 0, coarse timer") << conf;
+
+    conf.preciseTimer = true;
+    QTest::newRow("Local SQLite, refresh rate 0, precise timer") << conf;
+}
+
+
+void EventTimerLogicTest::adaptiveRefreshTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer (EventTimerBuilder::create(conf));
+    LatenessRecorder handler;
+    timer->clearAll();
+    timer->setEventHandler(&handler);
+    timer->start();
+
+    // Events occur long before the next periodic poll.
+    QDateTime first = QDateTime::currentDateTime().addMSecs(200);
+    for (int i=0; i<5; ++i){
+        Event e("adaptive"+QString::number(i),
+                first.addMSecs(i*100).toString(Event::TIME_FORMAT),
+                Event::DYNAMIC);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(handler.lateness.size(), std::vector<qint64>::size_type(5), 5000);
+    timer->stop();
+
+    for (qint64 l : handler.lateness){
+        QVERIFY(l >= 0);
+        QVERIFY(l < conf.refreshRateMsec);
+    }
+}
+
+
+void EventTimerLogicTest::adaptiveRefreshTest_data()
+{
+    QTest::addColumn<EventTimerNS::EventTimerBuilder::Configuration>("conf");
+
+    EventTimerNS::EventTimerBuilder::Configuration conf;
+    conf.dbType = "QSQLITE";
+    conf.dbName = "SQLiteTestDB";
+    conf.tableName = "events";
+    conf.refreshRateMsec = 60000;
+    conf.adaptiveRefresh = true;
+
+    conf.preciseTimer = false;
+    QTest::newRow("Local SQLite, adaptive refresh") << conf;
+
+    conf.preciseTimer = true;
+    QTest::newRow("Local SQLite, adaptive refresh, precise timer") << conf;
+}
+
+
+void EventTimerLogicTest::coalesceSlackTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer (EventTimerBuilder::create(conf));
+    LatenessRecorder handler;
+    timer->clearAll();
+    timer->setEventHandler(&handler);
+    timer->start();
+
+    // Three events within the slack window.
+    QDateTime first = QDateTime::currentDateTime().addMSecs(200);
+    std::vector<QDateTime> times;
+    for (int i=0; i<3; ++i){
+        times.push_back(first.addMSecs(i*30));
+        Event e("coalesced"+QString::number(i),
+                times.back().toString(Event::TIME_FORMAT),
+                Event::DYNAMIC);
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(handler.lateness.size(), std::vector<qint64>::size_type(3), 5000);
+    timer->stop();
+
+    // All events were fired in one tick, after the last one occured.
+    std::vector<qint64> l = handler.lateness;
+    std::sort(l.begin(), l.end());
+    QVERIFY(l.front() >= 0);
+    QVERIFY(l.back() >= first.msecsTo(times.back()));
+}
+
+
+void EventTimerLogicTest::coalesceSlackTest_data()
+{
+    QTest::addColumn<EventTimerNS::EventTimerBuilder::Configuration>("conf");
+
+    EventTimerNS::EventTimerBuilder::Configuration conf;
+    conf.dbType = "QSQLITE";
+    conf.dbName = "SQLiteTestDB";
+    conf.tableName = "events";
+    conf.refreshRateMsec = 0;
+    conf.coalesceSlackMsec = 100;
+    QTest::newRow("Local SQLite, refresh rate 0, 100ms slack") << conf;
+
+    conf.refreshRateMsec = 60000;
+    conf.adaptiveRefresh = true;
+    QTest::newRow("Local SQLite, adaptive refresh, 100ms slack") << conf;
+}
+
+
+void EventTimerLogicTest::statsTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer (EventTimerBuilder::create(conf));
+    HandlerStub handler;
+    timer->setEventHandler(&handler);
+    QVERIFY(timer->clearAll());
+
+    EventTimer::Statistics s = timer->stats();
+    QCOMPARE(s.insertStatements, quint64(0));
+    QCOMPARE(s.deleteStatements, quint64(1));
+    QCOMPARE(s.eventsFired, quint64(0));
+    QCOMPARE(s.queueDepth, quint64(0));
+
+    timer->start();
+
+    // One single-shot, one repeating and one distant event.
+    QDateTime current = QDateTime::currentDateTime();
+    Event single("single", current.addMSecs(100).toString(Event::TIME_FORMAT), Event::DYNAMIC);
+    Event repeating("repeating", current.addMSecs(100).toString(Event::TIME_FORMAT),
+                    Event::DYNAMIC, 60000, 1);
+    Event distant("distant", current.addDays(1).toString(Event::TIME_FORMAT), Event::DYNAMIC);
+    QVERIFY(timer->addEvent(&single) != Event::UNASSIGNED_ID);
+    QVERIFY(timer->addEvent(&repeating) != Event::UNASSIGNED_ID);
+    QVERIFY(timer->addEvent(&distant) != Event::UNASSIGNED_ID);
+
+    QTRY_COMPARE_WITH_TIMEOUT(handler.events.size(), std::vector<Event>::size_type(2), 5000);
+    timer->stop();
+
+    s = timer->stats();
+    QCOMPARE(s.insertStatements, quint64(3));
+    QCOMPARE(s.eventsFired, quint64(2));
+    QCOMPARE(s.eventsRescheduled, quint64(1));
+    QCOMPARE(s.eventsRemoved, quint64(1));
+    QCOMPARE(s.queueDepth, quint64(2));
+    QVERIFY(s.updateStatements >= 1);
+    QVERIFY(s.selectStatements >= 4);
+    QVERIFY(s.rowsScanned >= 2);
+    QVERIFY(s.databaseTimeNsec > 0);
+    QCOMPARE(timer->firingLateness().count(), s.eventsFired);
+    QCOMPARE(timer->stats().selectStatements, s.selectStatements);
+    QVERIFY(s.checks >= 1);
+    QVERIFY(s.checkTimeNsec >= s.handlerTimeNsec);
+    qDebug() << "Database time (ns):" << s.databaseTimeNsec
+             << "handler time (ns):" << s.handlerTimeNsec;
+}
+
+
+void EventTimerLogicTest::statsTest_data()
+{
+    QTest::addColumn<EventTimerNS::EventTimerBuilder::Configuration>("conf");
+
+    EventTimerNS::EventTimerBuilder::Configuration conf;
+    conf.dbType = "QSQLITE";
+    conf.dbName = "SQLiteTestDB";
+    conf.tableName = "events";
+    conf.refreshRateMsec = 0;
+    QTest::newRow("Local SQLite, refresh rate 0") << conf;
+}
+
+
+void EventTimerLogicTest::groupFiringTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer (EventTimerBuilder::create(conf));
+    HandlerStub handler;
+    timer->setEventHandler(&handler);
+    QVERIFY(timer->clearAll());
+
+    // Fifty single-shot and fifty repeating events due at the same time.
+    QString timestamp = QDateTime::currentDateTime().addMSecs(3000).toString(Event::TIME_FORMAT);
+    std::vector<unsigned> repeating;
+    for (int i=0; i<50; ++i){
+        Event single("single" + QString::number(i), timestamp, Event::STATIC);
+        Event repeated("repeating" + QString::number(i), timestamp, Event::STATIC, 60000, 3);
+        QVERIFY(timer->addEvent(&single) != Event::UNASSIGNED_ID);
+        QVERIFY(timer->addEvent(&repeated) != Event::UNASSIGNED_ID);
+        repeating.push_back(repeated.id());
+    }
+    timer->start();
+    EventTimer::Statistics before = timer->stats();
+
+    QTRY_COMPARE_WITH_TIMEOUT(handler.events.size(), std::vector<Event>::size_type(100), 10000);
+    timer->stop();
+
+    // Each group is updated or removed with one statement.
+    EventTimer::Statistics s = timer->stats();
+    QCOMPARE(s.updateStatements - before.updateStatements, quint64(1));
+    QCOMPARE(s.deleteStatements - before.deleteStatements, quint64(1));
+    QCOMPARE(s.eventsRescheduled, quint64(50));
+    QCOMPARE(s.eventsRemoved, quint64(50));
+    QCOMPARE(s.queueDepth, quint64(50));
+
+    QString next = QDateTime::fromString(timestamp, Event::TIME_FORMAT).addMSecs(60000)
+            .toString(Event::TIME_FORMAT);
+    for (unsigned id : repeating){
+        Event e = timer->getEvent(id);
+        QCOMPARE(e.timestamp(), next);
+        QCOMPARE(e.repeats(), 2u);
+    }
+    QVERIFY(timer->clearAll());
+}
+
+
+void EventTimerLogicTest::groupFiringTest_data()
+{
+    statsTest_data();
+}
+
+
+void EventTimerLogicTest::logLevelFilterTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    WarningLoggerStub logger;
+    timer->setLogger(&logger);
+
+    // Successful operations are logged at LEVEL_INFO level.
+    QVERIFY(timer->clearAll());
+    Event e("name", "2000-01-01 00:00:00:000", Event::STATIC, 1000, 10);
+    QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    QVERIFY(timer->removeEvent(e.id()));
+    QCOMPARE(logger.messages.size(), QStringList::size_type(0));
+
+    // Missing event is logged as a warning.
+    QCOMPARE(timer->getEvent(e.id()).id(), Event::UNASSIGNED_ID);
+    QCOMPARE(logger.messages.size(), QStringList::size_type(1));
+    QCOMPARE(logger.levels.at(0), Logger::LEVEL_WARNING);
+    qDebug() << logger.messages.at(0);
+}
+
+
+void EventTimerLogicTest::logLevelFilterTest_data()
+{
+    invalidBuildetTest_data();
+}
+
+
+void EventTimerLogicTest::traceTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    HandlerStub handler;
+    timer->setEventHandler(&handler);
+    QVERIFY(timer->clearAll());
+
+    TraceRecorder recorder;
+    timer->setTraceRecorder(&recorder);
+    timer->start();
+    Event e("traced", QDateTime::currentDateTime().addMSecs(100).toString(Event::TIME_FORMAT),
+            Event::DYNAMIC);
+    QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    QTRY_COMPARE_WITH_TIMEOUT(handler.events.size(), std::vector<Event>::size_type(1), 5000);
+    timer->stop();
+
+    // Spans of the firing check are nested in the check span.
+    std::vector<TraceRecorder::Span> spans = recorder.spans();
+    auto find = [&](const char* name){
+        return std::find_if(spans.begin(), spans.end(), [&](const TraceRecorder::Span& s){
+            return QByteArray(s.name) == name;
+        });
+    };
+    QVERIFY(find("DatabaseHandler::addEvent") != spans.end());
+    QVERIFY(find("DatabaseHandler::checkOccured") != spans.end());
+    QVERIFY(find("EventTimerLogic::updateExpired") != spans.end());
+    auto notify = find("EventHandler::notify");
+    QVERIFY(notify != spans.end());
+    auto check = std::find_if(notify, spans.end(), [](const TraceRecorder::Span& s){
+        return QByteArray(s.name) == "EventTimerLogic::checkEvents";
+    });
+    QVERIFY(check != spans.end());
+    QVERIFY(check->startNsec <= notify->startNsec);
+    QVERIFY(check->startNsec + check->durationNsec >= notify->startNsec + notify->durationNsec);
+    QCOMPARE(recorder.dropped(), quint64(0));
+
+    // Nothing is recorded after tracing is disabled.
+    timer->setTraceRecorder(nullptr);
+    unsigned size = recorder.size();
+    QVERIFY(timer->clearAll());
+    QCOMPARE(recorder.size(), size);
+}
+
+
+void EventTimerLogicTest::traceTest_data()
+{
+    statsTest_data();
+}
+
+
+void EventTimerLogicTest::scheduleViewTest()
+{
+    QFETCH(EventTimerNS::EventTimerBuilder::Configuration, conf);
+
+    using namespace EventTimerNS;
+    conf.scheduleViewKey = "EventTimerLogicTest-" + QString::number(QCoreApplication::applicationPid());
+    conf.scheduleViewSize = 2;
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+    QVERIFY2(timer->isValid(), qPrintable(timer->errorString()));
+    HandlerStub handler;
+    timer->setEventHandler(&handler);
+    QVERIFY(timer->clearAll());
+
+    ScheduleView view(conf.scheduleViewKey);
+    QVERIFY2(view.attach(), qPrintable(view.errorString()));
+    ScheduleView::State state;
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 0u);
+
+    // View holds the two earliest events.
+    QDateTime now = QDateTime::currentDateTime();
+    std::vector<Event> events = {
+        Event("late", now.addDays(3).toString(Event::TIME_FORMAT), Event::STATIC),
+        Event("early", now.addDays(1).toString(Event::TIME_FORMAT), Event::STATIC),
+        Event("middle", now.addDays(2).toString(Event::TIME_FORMAT), Event::STATIC)
+    };
+    for (Event& e : events){
+        QVERIFY(timer->addEvent(&e) != Event::UNASSIGNED_ID);
+    }
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 3u);
+    QCOMPARE(state.upcoming.size(), std::size_t(2));
+    QCOMPARE(state.upcoming[0].id, events[1].id());
+    QCOMPARE(state.upcoming[0].dueMsec, now.addDays(1).toMSecsSinceEpoch());
+    QCOMPARE(state.upcoming[1].id, events[2].id());
+
+    // Fired events leave the view.
+    timer->start();
+    Event soon("soon", now.addMSecs(100).toString(Event::TIME_FORMAT), Event::DYNAMIC);
+    QVERIFY(timer->addEvent(&soon) != Event::UNASSIGNED_ID);
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 4u);
+    QCOMPARE(state.upcoming[0].id, soon.id());
+    QTRY_COMPARE_WITH_TIMEOUT(handler.events.size(), std::vector<Event>::size_type(1), 5000);
+    timer->stop();
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 3u);
+    QCOMPARE(state.upcoming[0].id, events[1].id());
+
+    QVERIFY(timer->clearAll());
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 0u);
+    QVERIFY(state.upcoming.empty());
+}
+
+
+void EventTimerLogicTest::scheduleViewTest_data()
+{
+    statsTest_data();
+}
+
+
+void EventTimerLogicTest::scheduleViewNotLoadedTest()
+{
+    using namespace EventTimerNS;
+    // Table without timestamp column, so that due times can not be queried.
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "NotLoadedTestConnection");
+        db.setDatabaseName("SQLiteTestDB");
+        QVERIFY(db.open());
+        QSqlQuery q(db);
+        QVERIFY(q.exec("DROP TABLE IF EXISTS notloaded"));
+        QVERIFY(q.exec("CREATE TABLE notloaded (id INTEGER PRIMARY KEY, name TEXT)"));
+    }
+    QSqlDatabase::removeDatabase("NotLoadedTestConnection");
+
+    EventTimerBuilder::Configuration conf;
+    conf.dbType = "QSQLITE";
+    conf.dbName = "SQLiteTestDB";
+    conf.tableName = "notloaded";
+    conf.refreshRateMsec = 0;
+    conf.scheduleViewKey = "EventTimerLogicTest-notloaded-" + QString::number(QCoreApplication::applicationPid());
+    std::shared_ptr<EventTimer> timer(EventTimerBuilder::create(conf));
+
+    // Only the initial write of the segment is visible. Empty schedule is not published.
+    ScheduleView view(conf.scheduleViewKey);
+    QVERIFY2(view.attach(), qPrintable(view.errorString()));
+    ScheduleView::State state;
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.generation, 1u);
+    QVERIFY(state.upcoming.empty());
+}
+
+
 void EventTimerLogicTest::compareEvents(const EventTimerNS::Event& e1,
                                         const EventTimerNS::Event& e2) const
 {
@@ -537,6 +1307,6 @@ void EventTimerLogicTest::compareEvents(const EventTimerNS::Event& e1,
 }
 
 
-QTEST_APPLESS_MAIN(EventTimerLogicTest)
+QTEST_GUILESS_MAIN(EventTimerLogicTest)
 
 #include "tst_eventtimerlogictest.moc"
@@ -0,0 +1,22 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_latencyhistogramtest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH +=  ../../EventTimer/inc/
+
+DEPENDPATH += \
+    ../../EventTimer/src/ \
+    ../../EventTimer/inc/
+
+SOURCES += \
+    tst_latencyhistogramtest.cc \
+    ../../EventTimer/src/latencyhistogram.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
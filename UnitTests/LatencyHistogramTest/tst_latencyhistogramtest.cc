@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::LatencyHistogram class.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include "latencyhistogram.hh"
+
+/**
+ * @brief Unit tests for the EventTimerNS::LatencyHistogram class.
+ */
+class LatencyHistogramTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    LatencyHistogramTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test empty histogram.
+     */
+    void emptyTest();
+
+    /**
+     * @brief Test that small values are counted exactly.
+     */
+    void exactValuesTest();
+
+    /**
+     * @brief Test percentile precision with uniformly distributed values.
+     */
+    void percentilePrecisionTest();
+    void percentilePrecisionTest_data();
+
+    /**
+     * @brief Test recording values out of the trackable range.
+     */
+    void clampTest();
+
+    /**
+     * @brief Test resetting the histogram.
+     */
+    void resetTest();
+};
+
+LatencyHistogramTest::LatencyHistogramTest()
+{
+}
+
+
+void LatencyHistogramTest::emptyTest()
+{
+    EventTimerNS::LatencyHistogram h;
+    QCOMPARE(h.count(), quint64(0));
+    QCOMPARE(h.min(), qint64(0));
+    QCOMPARE(h.max(), qint64(0));
+    QCOMPARE(h.mean(), 0.0);
+    QCOMPARE(h.percentile(50), qint64(0));
+    QCOMPARE(h.percentile(100), qint64(0));
+}
+
+
+void LatencyHistogramTest::exactValuesTest()
+{
+    EventTimerNS::LatencyHistogram h;
+    for (qint64 i=0; i<100; ++i){
+        h.record(i);
+    }
+
+    QCOMPARE(h.count(), quint64(100));
+    QCOMPARE(h.min(), qint64(0));
+    QCOMPARE(h.max(), qint64(99));
+    QCOMPARE(h.mean(), 49.5);
+    QCOMPARE(h.percentile(0), qint64(0));
+    QCOMPARE(h.percentile(1), qint64(0));
+    QCOMPARE(h.percentile(50), qint64(49));
+    QCOMPARE(h.percentile(99), qint64(98));
+    QCOMPARE(h.percentile(100), qint64(99));
+}
+
+
+void LatencyHistogramTest::percentilePrecisionTest()
+{
+    QFETCH(qint64, maxValue);
+    QFETCH(double, percentile);
+
+    EventTimerNS::LatencyHistogram h;
+    for (qint64 i=1; i<=maxValue; ++i){
+        h.record(i);
+    }
+
+    double expected = percentile / 100 * maxValue;
+    double actual = h.percentile(percentile);
+    QVERIFY(actual >= expected);
+    QVERIFY(actual <= expected * 1.016 + 1);
+}
+
+
+void LatencyHistogramTest::percentilePrecisionTest_data()
+{
+    QTest::addColumn<qint64>("maxValue");
+    QTest::addColumn<double>("percentile");
+
+    QTest::newRow("p50 of 1000") << qint64(1000) << 50.0;
+    QTest::newRow("p99 of 1000") << qint64(1000) << 99.0;
+    QTest::newRow("p999 of 1000") << qint64(1000) << 99.9;
+    QTest::newRow("p50 of 100000") << qint64(100000) << 50.0;
+    QTest::newRow("p99 of 100000") << qint64(100000) << 99.0;
+    QTest::newRow("p999 of 100000") << qint64(100000) << 99.9;
+}
+
+
+void LatencyHistogramTest::clampTest()
+{
+    using EventTimerNS::LatencyHistogram;
+    LatencyHistogram h;
+    h.record(-10);
+    h.record(LatencyHistogram::MAX_VALUE + 1000);
+
+    QCOMPARE(h.count(), quint64(2));
+    QCOMPARE(h.min(), qint64(0));
+    QCOMPARE(h.max(), LatencyHistogram::MAX_VALUE);
+    QCOMPARE(h.percentile(50), qint64(0));
+    QCOMPARE(h.percentile(100), LatencyHistogram::MAX_VALUE);
+}
+
+
+void LatencyHistogramTest::resetTest()
+{
+    EventTimerNS::LatencyHistogram h;
+    h.record(5);
+    h.record(500);
+    h.reset();
+
+    QCOMPARE(h.count(), quint64(0));
+    QCOMPARE(h.max(), qint64(0));
+    h.record(7);
+    QCOMPARE(h.min(), qint64(7));
+    QCOMPARE(h.percentile(100), qint64(7));
+}
+
+
+QTEST_APPLESS_MAIN(LatencyHistogramTest)
+
+#include "tst_latencyhistogramtest.moc"
@@ -0,0 +1,22 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_namepooltest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/src/
+
+DEPENDPATH += \
+    ../../EventTimer/src/
+
+SOURCES += \
+    tst_namepooltest.cc \
+    ../../EventTimer/src/namepool.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
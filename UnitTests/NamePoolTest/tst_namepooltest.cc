@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::NamePool class.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include "namepool.hh"
+
+/**
+ * @brief Unit tests for the EventTimerNS::NamePool class.
+ */
+class NamePoolTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    NamePoolTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test that equal names share data.
+     */
+    void internTest();
+
+    /**
+     * @brief Test that names are not pooled when the pool is full.
+     */
+    void capacityTest();
+
+    /**
+     * @brief Test that capacity 0 disables interning.
+     */
+    void disabledTest();
+
+    /**
+     * @brief Test clearing the pool.
+     */
+    void clearTest();
+};
+
+NamePoolTest::NamePoolTest()
+{
+}
+
+
+void NamePoolTest::internTest()
+{
+    EventTimerNS::NamePool pool(10);
+
+    // Equal strings built separately do not share data.
+    QString first = pool.intern(QString("na") + "me");
+    QString second = pool.intern(QString("nam") + "e");
+    QCOMPARE(second, QString("name"));
+    QVERIFY(first.constData() == second.constData());
+
+    QString other = pool.intern("other");
+    QCOMPARE(other, QString("other"));
+    QVERIFY(other.constData() != first.constData());
+    QCOMPARE(pool.size(), 2u);
+}
+
+
+void NamePoolTest::capacityTest()
+{
+    EventTimerNS::NamePool pool(2);
+    pool.intern("a");
+    pool.intern("b");
+
+    QString c1 = pool.intern(QString("c") + "c");
+    QString c2 = pool.intern(QString("c") + "c");
+    QCOMPARE(c1, c2);
+    QVERIFY(c1.constData() != c2.constData());
+    QCOMPARE(pool.size(), 2u);
+
+    // Pooled names are still shared.
+    QString a = pool.intern(QString("a") + "");
+    QVERIFY(a.constData() == pool.intern("a").constData());
+}
+
+
+void NamePoolTest::disabledTest()
+{
+    EventTimerNS::NamePool pool(0);
+    QString n1 = pool.intern(QString("na") + "me");
+    QString n2 = pool.intern(QString("nam") + "e");
+    QCOMPARE(n1, n2);
+    QVERIFY(n1.constData() != n2.constData());
+    QCOMPARE(pool.size(), 0u);
+}
+
+
+void NamePoolTest::clearTest()
+{
+    EventTimerNS::NamePool pool(10);
+    QString before = pool.intern(QString("na") + "me");
+    pool.clear();
+    QCOMPARE(pool.size(), 0u);
+    QCOMPARE(before, QString("name"));
+
+    QString after = pool.intern(QString("nam") + "e");
+    QVERIFY(after.constData() != before.constData());
+    QCOMPARE(pool.size(), 1u);
+}
+
+
+QTEST_APPLESS_MAIN(NamePoolTest)
+
+#include "tst_namepooltest.moc"
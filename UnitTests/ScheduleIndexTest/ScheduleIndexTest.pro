@@ -0,0 +1,21 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_scheduleindextest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH +=  ../../EventTimer/src/
+
+DEPENDPATH += \
+    ../../EventTimer/src/
+
+SOURCES += \
+    tst_scheduleindextest.cc \
+    ../../EventTimer/src/scheduleindex.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
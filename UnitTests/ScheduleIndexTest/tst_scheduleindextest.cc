@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::ScheduleIndex class.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include "scheduleindex.hh"
+
+/**
+ * @brief Unit tests for the EventTimerNS::ScheduleIndex class.
+ */
+class ScheduleIndexTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScheduleIndexTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test empty index.
+     */
+    void emptyTest();
+
+    /**
+     * @brief Test that earliest due time follows insertions and removals.
+     */
+    void earliestTest();
+
+    /**
+     * @brief Test moving indexed events.
+     */
+    void moveTest();
+
+    /**
+     * @brief Test finding the latest due time within a window.
+     */
+    void latestWithinTest();
+
+    /**
+     * @brief Test paging through a time range.
+     */
+    void rangeTest();
+
+    /**
+     * @brief Test listing the next occuring events.
+     */
+    void upcomingTest();
+};
+
+ScheduleIndexTest::ScheduleIndexTest()
+{
+}
+
+
+void ScheduleIndexTest::emptyTest()
+{
+    EventTimerNS::ScheduleIndex index;
+    QVERIFY(index.empty());
+    QCOMPARE(index.size(), 0u);
+    QVERIFY(!index.contains(1));
+    QVERIFY(!index.remove(1));
+}
+
+
+void ScheduleIndexTest::earliestTest()
+{
+    EventTimerNS::ScheduleIndex index;
+    index.insert(1, 300);
+    index.insert(2, 100);
+    index.insert(3, 200);
+    index.insert(4, 100);
+
+    QCOMPARE(index.size(), 4u);
+    QCOMPARE(index.earliest(), qint64(100));
+
+    QVERIFY(index.remove(2));
+    QCOMPARE(index.earliest(), qint64(100));
+    QVERIFY(index.remove(4));
+    QCOMPARE(index.earliest(), qint64(200));
+    QVERIFY(!index.contains(4));
+    QVERIFY(index.contains(3));
+
+    index.clear();
+    QVERIFY(index.empty());
+    QVERIFY(!index.contains(1));
+}
+
+
+void ScheduleIndexTest::moveTest()
+{
+    EventTimerNS::ScheduleIndex index;
+    index.insert(1, 100);
+    index.insert(2, 200);
+
+    // Move earliest event after the other one.
+    index.insert(1, 300);
+    QCOMPARE(index.size(), 2u);
+    QCOMPARE(index.earliest(), qint64(200));
+
+    // Move it back to front.
+    index.insert(1, 50);
+    QCOMPARE(index.earliest(), qint64(50));
+
+    // Same due time does not duplicate the entry.
+    index.insert(1, 50);
+    QCOMPARE(index.size(), 2u);
+    QVERIFY(index.remove(1));
+    QCOMPARE(index.earliest(), qint64(200));
+    QCOMPARE(index.size(), 1u);
+}
+
+
+void ScheduleIndexTest::latestWithinTest()
+{
+    EventTimerNS::ScheduleIndex index;
+    index.insert(1, 1000);
+    index.insert(2, 1040);
+    index.insert(3, 1100);
+    index.insert(4, 1101);
+
+    QCOMPARE(index.latestWithin(0), qint64(1000));
+    QCOMPARE(index.latestWithin(39), qint64(1000));
+    QCOMPARE(index.latestWithin(40), qint64(1040));
+    QCOMPARE(index.latestWithin(100), qint64(1100));
+    QCOMPARE(index.latestWithin(5000), qint64(1101));
+}
+
+
+void ScheduleIndexTest::rangeTest()
+{
+    // Pairs of events share due time: ids 1,2 at 100, ids 3,4 at 200, ... ids 9,10 at 500.
+    EventTimerNS::ScheduleIndex index;
+    for (unsigned id=1; id<=10; ++id){
+        index.insert(id, 100 * ((id+1) / 2));
+    }
+
+    std::vector<unsigned> page = index.range(100, 400, 3);
+    QCOMPARE(page, std::vector<unsigned>({1, 2, 3}));
+    page = index.range(100, 400, 3, 200, 3);
+    QCOMPARE(page, std::vector<unsigned>({4, 5, 6}));
+    page = index.range(100, 400, 3, 300, 6);
+    QVERIFY(page.empty());
+
+    // Cursor before range start.
+    page = index.range(250, 1000, 100, 50, 1);
+    QCOMPARE(page, std::vector<unsigned>({5, 6, 7, 8, 9, 10}));
+
+    // Cursor after the last entry.
+    QVERIFY(index.range(0, 1000, 100, 500, 10).empty());
+
+    // Due times before 1970 are negative. Cursor on them must still apply.
+    EventTimerNS::ScheduleIndex early;
+    for (unsigned id=1; id<=5; ++id){
+        early.insert(id, -100 * static_cast<qint64>(6 - id));
+    }
+    page = early.range(-1000, 0, 2);
+    QCOMPARE(page, std::vector<unsigned>({1, 2}));
+    page = early.range(-1000, 0, 2, -400, 2);
+    QCOMPARE(page, std::vector<unsigned>({3, 4}));
+    page = early.range(-1000, 0, 2, -200, 4);
+    QCOMPARE(page, std::vector<unsigned>({5}));
+    QVERIFY(early.range(-1000, 0, 2, -100, 5).empty());
+}
+
+
+void ScheduleIndexTest::upcomingTest()
+{
+    EventTimerNS::ScheduleIndex index;
+    std::vector<std::pair<qint64, unsigned> > entries = {{1, 99}};
+    index.upcoming(10, &entries);
+    QVERIFY(entries.empty());
+
+    index.insert(3, 300);
+    index.insert(1, 100);
+    index.insert(2, 100);
+    index.insert(4, 50);
+    index.upcoming(3, &entries);
+    std::vector<std::pair<qint64, unsigned> > expected = {{50, 4}, {100, 1}, {100, 2}};
+    QCOMPARE(entries, expected);
+
+    index.remove(4);
+    index.upcoming(10, &entries);
+    expected = {{100, 1}, {100, 2}, {300, 3}};
+    QCOMPARE(entries, expected);
+}
+
+
+QTEST_APPLESS_MAIN(ScheduleIndexTest)
+
+#include "tst_scheduleindextest.moc"
@@ -0,0 +1,26 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_scheduleviewtest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+DEPENDPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+SOURCES += \
+    tst_scheduleviewtest.cc \
+    ../../EventTimer/src/scheduleview.cc \
+    ../../EventTimer/src/schedulepublisher.cc \
+    ../../EventTimer/src/scheduleindex.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,216 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::ScheduleView and EventTimerNS::SchedulePublisher classes.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include <QThread>
+#include <QCoreApplication>
+#include <atomic>
+#include "scheduleview.hh"
+#include "schedulepublisher.hh"
+
+
+namespace
+{
+
+// Key unique to this process and test.
+QString viewKey(const QString& test)
+{
+    return "ScheduleViewTest-" + QString::number(QCoreApplication::applicationPid()) + "-" + test;
+}
+
+
+// Publishes schedules where every event is due at the same time as
+// the number of events, so that a torn read is detectable.
+class PublisherThread : public QThread
+{
+public:
+    PublisherThread(EventTimerNS::SchedulePublisher* publisher, unsigned maxEvents) :
+        QThread(), publisher_(publisher), maxEvents_(maxEvents), stop_(false)
+    {
+    }
+
+    void stop()
+    {
+        stop_ = true;
+    }
+
+protected:
+    void run()
+    {
+        for (unsigned round = 0; !stop_; ++round){
+            EventTimerNS::ScheduleIndex index;
+            unsigned count = round % maxEvents_ + 1;
+            for (unsigned id = 1; id <= count; ++id){
+                index.insert(id, count);
+            }
+            publisher_->publish(index);
+        }
+    }
+
+private:
+    EventTimerNS::SchedulePublisher* publisher_;
+    unsigned maxEvents_;
+    std::atomic<bool> stop_;
+};
+
+} // Anonymous namespace
+
+
+/**
+ * @brief Unit tests for the EventTimerNS::ScheduleView class.
+ */
+class ScheduleViewTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScheduleViewTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test reading published schedules.
+     */
+    void publishTest();
+
+    /**
+     * @brief Test that only the earliest events fit into the view.
+     */
+    void capacityTest();
+
+    /**
+     * @brief Test attaching to a view that does not exist.
+     */
+    void missingViewTest();
+
+    /**
+     * @brief Test that reads are consistent while schedule is published from another thread.
+     */
+    void concurrentTest();
+};
+
+
+ScheduleViewTest::ScheduleViewTest()
+{
+}
+
+
+void ScheduleViewTest::publishTest()
+{
+    using namespace EventTimerNS;
+    SchedulePublisher publisher(viewKey("publish"), 10);
+    QVERIFY2(publisher.isValid(), qPrintable(publisher.errorString()));
+
+    ScheduleView view(viewKey("publish"));
+    QVERIFY(!view.isAttached());
+    QVERIFY2(view.attach(), qPrintable(view.errorString()));
+    QVERIFY(view.isAttached());
+
+    // Empty schedule is published on creation.
+    ScheduleView::State state;
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 0u);
+    QVERIFY(state.upcoming.empty());
+    QVERIFY(state.publishedMsec > 0);
+    unsigned generation = state.generation;
+
+    ScheduleIndex index;
+    index.insert(3, 3000);
+    index.insert(1, 1000);
+    index.insert(2, 1000);
+    publisher.publish(index);
+
+    QVERIFY(view.read(&state));
+    QVERIFY(state.generation != generation);
+    QCOMPARE(state.eventCount, 3u);
+    QCOMPARE(state.upcoming.size(), std::size_t(3));
+    QCOMPARE(state.upcoming[0].id, 1u);
+    QCOMPARE(state.upcoming[0].dueMsec, qint64(1000));
+    QCOMPARE(state.upcoming[1].id, 2u);
+    QCOMPARE(state.upcoming[1].dueMsec, qint64(1000));
+    QCOMPARE(state.upcoming[2].id, 3u);
+    QCOMPARE(state.upcoming[2].dueMsec, qint64(3000));
+
+    index.remove(1);
+    publisher.publish(index);
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 2u);
+    QCOMPARE(state.upcoming.size(), std::size_t(2));
+    QCOMPARE(state.upcoming[0].id, 2u);
+}
+
+
+void ScheduleViewTest::capacityTest()
+{
+    using namespace EventTimerNS;
+    SchedulePublisher publisher(viewKey("capacity"), 4);
+    QVERIFY2(publisher.isValid(), qPrintable(publisher.errorString()));
+
+    ScheduleIndex index;
+    for (unsigned id = 1; id <= 100; ++id){
+        index.insert(id, 1000 - id);
+    }
+    publisher.publish(index);
+
+    ScheduleView view(viewKey("capacity"));
+    QVERIFY(view.attach());
+    ScheduleView::State state;
+    QVERIFY(view.read(&state));
+    QCOMPARE(state.eventCount, 100u);
+    QCOMPARE(state.upcoming.size(), std::size_t(4));
+    for (unsigned i = 0; i < 4; ++i){
+        QCOMPARE(state.upcoming[i].id, 100 - i);
+        QCOMPARE(state.upcoming[i].dueMsec, qint64(900 + i));
+    }
+}
+
+
+void ScheduleViewTest::missingViewTest()
+{
+    EventTimerNS::ScheduleView view(viewKey("missing"));
+    QVERIFY(!view.attach());
+    QVERIFY(!view.isAttached());
+    QVERIFY(!view.errorString().isEmpty());
+}
+
+
+void ScheduleViewTest::concurrentTest()
+{
+    using namespace EventTimerNS;
+    const unsigned MAX_EVENTS = 32;
+    SchedulePublisher publisher(viewKey("concurrent"), MAX_EVENTS);
+    QVERIFY2(publisher.isValid(), qPrintable(publisher.errorString()));
+    ScheduleView view(viewKey("concurrent"));
+    QVERIFY(view.attach());
+
+    PublisherThread thread(&publisher, MAX_EVENTS);
+    thread.start();
+
+    // Thread is stopped before checking results.
+    ScheduleView::State state;
+    unsigned reads = 0;
+    unsigned torn = 0;
+    for (unsigned i = 0; i < 100000; ++i){
+        if (!view.read(&state)) continue;
+        ++reads;
+        if (state.eventCount == 0) continue;
+        bool consistent = state.upcoming.size() == state.eventCount;
+        for (const ScheduleView::Entry& entry : state.upcoming){
+            consistent = consistent && entry.dueMsec == qint64(state.eventCount);
+        }
+        if (!consistent) ++torn;
+    }
+    thread.stop();
+    QVERIFY(thread.wait(30000));
+    QVERIFY(reads > 0);
+    QCOMPARE(torn, 0u);
+}
+
+
+QTEST_APPLESS_MAIN(ScheduleViewTest)
+
+#include "tst_scheduleviewtest.moc"
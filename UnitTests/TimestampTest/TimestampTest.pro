@@ -0,0 +1,25 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_timestamptest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+DEPENDPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+SOURCES += \
+    tst_timestamptest.cc \
+    ../../EventTimer/src/timestamp.cc \
+    ../../EventTimer/src/event.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
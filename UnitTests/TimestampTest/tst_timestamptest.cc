@@ -0,0 +1,286 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::Timestamp class. Results are
+ *  compared against QDateTime conversions with Event::TIME_FORMAT.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include <QDateTime>
+#include <time.h>
+#include <vector>
+#include "timestamp.hh"
+#include "event.hh"
+
+using EventTimerNS::Event;
+using EventTimerNS::Timestamp;
+
+/**
+ * @brief Unit tests for the EventTimerNS::Timestamp class.
+ */
+class TimestampTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    TimestampTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Use a time zone with daylight saving time, so that
+     *  transition days are tested as well.
+     */
+    void initTestCase();
+
+    /**
+     * @brief Test formatting and parsing times over several years against QDateTime.
+     */
+    void roundTripTest();
+    void roundTripTest_data();
+
+    /**
+     * @brief Test parsing every minute of daylight saving transition days,
+     *  including skipped and repeated local times.
+     */
+    void transitionTest();
+    void transitionTest_data();
+
+    /**
+     * @brief Test parsing valid timestamps.
+     */
+    void validTest();
+    void validTest_data();
+
+    /**
+     * @brief Test that invalid timestamps are rejected.
+     */
+    void invalidTest();
+    void invalidTest_data();
+
+    /**
+     * @brief Test parsing arrays of timestamps with and without SIMD decoding.
+     */
+    void batchTest();
+    void batchTest_data();
+
+    /**
+     * @brief Test formatting current time.
+     */
+    void nowTest();
+};
+
+
+TimestampTest::TimestampTest()
+{
+}
+
+
+void TimestampTest::initTestCase()
+{
+#ifdef Q_OS_UNIX
+    qputenv("TZ", "Europe/Helsinki");
+    tzset();
+#endif
+}
+
+
+void TimestampTest::roundTripTest()
+{
+    QFETCH(QString, from);
+    QFETCH(QString, to);
+    QFETCH(qint64, step);
+
+    qint64 end = QDateTime::fromString(to, Event::TIME_FORMAT).toMSecsSinceEpoch();
+    for (qint64 t = QDateTime::fromString(from, Event::TIME_FORMAT).toMSecsSinceEpoch(); t < end; t += step){
+        QString expected = QDateTime::fromMSecsSinceEpoch(t).toString(Event::TIME_FORMAT);
+        QString timestamp = Timestamp::format(t);
+        if (timestamp != expected){
+            QFAIL(qPrintable("Formatting " + QString::number(t) + " gave " + timestamp + ", expected " + expected));
+        }
+
+        qint64 parsed = 0;
+        QVERIFY(Timestamp::parse(timestamp, &parsed));
+        qint64 reference = QDateTime::fromString(timestamp, Event::TIME_FORMAT).toMSecsSinceEpoch();
+        if (parsed != reference){
+            QFAIL(qPrintable("Parsing " + timestamp + " gave " + QString::number(parsed) +
+                             ", expected " + QString::number(reference)));
+        }
+    }
+}
+
+
+void TimestampTest::roundTripTest_data()
+{
+    QTest::addColumn<QString>("from");
+    QTest::addColumn<QString>("to");
+    QTest::addColumn<qint64>("step");
+
+    QTest::newRow("2015-2017") << "2015-01-01 00:00:00:000" << "2018-01-01 00:00:00:000" << qint64(599999);
+    QTest::newRow("1970-2100") << "1970-01-01 00:00:00:000" << "2100-01-01 00:00:00:000" << qint64(86400000 - 1);
+    QTest::newRow("spring 2016") << "2016-03-26 00:00:00:000" << "2016-03-29 00:00:00:000" << qint64(60001);
+    QTest::newRow("autumn 2016") << "2016-10-29 00:00:00:000" << "2016-11-01 00:00:00:000" << qint64(60001);
+    QTest::newRow("year change") << "2016-12-31 23:59:58:000" << "2017-01-01 00:00:02:000" << qint64(1);
+}
+
+
+void TimestampTest::transitionTest()
+{
+    QFETCH(QString, date);
+
+    for (int minute = 0; minute < 24 * 60; ++minute){
+        QString timestamp = date + QString(" %1:%2:30:500").arg(minute / 60, 2, 10, QChar('0'))
+                .arg(minute % 60, 2, 10, QChar('0'));
+        QDateTime reference = QDateTime::fromString(timestamp, Event::TIME_FORMAT);
+
+        qint64 parsed = 0;
+        QCOMPARE(Timestamp::parse(timestamp, &parsed), reference.isValid());
+        QCOMPARE(Timestamp::isValid(timestamp), reference.isValid());
+        if (reference.isValid()){
+            QCOMPARE(parsed, reference.toMSecsSinceEpoch());
+        }
+    }
+}
+
+
+void TimestampTest::transitionTest_data()
+{
+    QTest::addColumn<QString>("date");
+    QTest::newRow("day before spring") << "2016-03-26";
+    QTest::newRow("spring") << "2016-03-27";
+    QTest::newRow("autumn") << "2016-10-30";
+    QTest::newRow("day after autumn") << "2016-10-31";
+}
+
+
+void TimestampTest::validTest()
+{
+    QFETCH(QString, timestamp);
+
+    qint64 parsed = 0;
+    QVERIFY(Timestamp::parse(timestamp, &parsed));
+    QVERIFY(Timestamp::isValid(timestamp));
+    QCOMPARE(parsed, QDateTime::fromString(timestamp, Event::TIME_FORMAT).toMSecsSinceEpoch());
+    QCOMPARE(Timestamp::format(parsed), timestamp);
+}
+
+
+void TimestampTest::validTest_data()
+{
+    QTest::addColumn<QString>("timestamp");
+    QTest::newRow("epoch") << "1970-01-01 00:00:00:000";
+    QTest::newRow("before epoch") << "1969-12-31 23:59:59:999";
+    QTest::newRow("leap day") << "2016-02-29 12:00:00:000";
+    QTest::newRow("leap day 2000") << "2000-02-29 12:00:00:000";
+    QTest::newRow("end of day") << "2016-05-16 23:59:59:999";
+    QTest::newRow("end of year") << "2016-12-31 23:59:59:999";
+    QTest::newRow("far future") << "9999-12-31 12:00:00:000";
+}
+
+
+void TimestampTest::invalidTest()
+{
+    QFETCH(QString, timestamp);
+
+    qint64 parsed = 42;
+    QVERIFY(!Timestamp::parse(timestamp, &parsed));
+    QVERIFY(!Timestamp::isValid(timestamp));
+    QCOMPARE(parsed, qint64(42));
+}
+
+
+void TimestampTest::invalidTest_data()
+{
+    QTest::addColumn<QString>("timestamp");
+    QTest::newRow("empty") << "";
+    QTest::newRow("too short") << "2016-05-16 12:00:00:00";
+    QTest::newRow("too long") << "2016-05-16 12:00:00:0000";
+    QTest::newRow("date only") << "2016-05-16";
+    QTest::newRow("wrong separator") << "2016-05-16 12:00:00.000";
+    QTest::newRow("wrong order") << "16-05-2016 12:00:00:000";
+    QTest::newRow("letters") << "2016-O5-16 12:00:00:000";
+    QTest::newRow("sign") << "2016-05-16 12:00:00:-00";
+    QTest::newRow("month 0") << "2016-00-16 12:00:00:000";
+    QTest::newRow("month 13") << "2016-13-16 12:00:00:000";
+    QTest::newRow("day 0") << "2016-05-00 12:00:00:000";
+    QTest::newRow("april 31") << "2016-04-31 12:00:00:000";
+    QTest::newRow("february 30") << "2016-02-30 12:00:00:000";
+    QTest::newRow("not leap year") << "2015-02-29 12:00:00:000";
+    QTest::newRow("not leap year 1900") << "1900-02-29 12:00:00:000";
+    QTest::newRow("year 0") << "0000-05-16 12:00:00:000";
+    QTest::newRow("hour 24") << "2016-05-16 24:00:00:000";
+    QTest::newRow("minute 60") << "2016-05-16 12:60:00:000";
+    QTest::newRow("second 60") << "2016-05-16 12:00:60:000";
+}
+
+
+void TimestampTest::batchTest()
+{
+    QFETCH(bool, allowSimd);
+
+    // Mix of ordered and repeated timestamps, transition days and invalid values.
+    std::vector<QString> timestamps;
+    qint64 t = QDateTime::fromString("2016-03-26 23:00:00:000", Event::TIME_FORMAT).toMSecsSinceEpoch();
+    for (int i=0; i<5000; ++i){
+        QString timestamp = QDateTime::fromMSecsSinceEpoch(t).toString(Event::TIME_FORMAT);
+        timestamps.push_back(timestamp);
+        if (i % 7 == 0) timestamps.push_back(timestamp);
+        t += 60013;
+    }
+    timestamps.push_back("2016-03-27 03:30:00:000");
+    timestamps.push_back("2016-10-30 03:30:00:000");
+    timestamps.push_back("1969-12-31 23:59:59:999");
+    timestamps.push_back("");
+    timestamps.push_back("2016-05-16 12:00:00:00");
+    timestamps.push_back("2016-02-30 12:00:00:000");
+    timestamps.push_back("2016-05-16 12:00:00:000");
+    timestamps.push_back("2016-05-16 12:00:00.000");
+    timestamps.push_back(QString("2016-05-16 12:00:00:00") + QChar(0x0660));   // Arabic-indic zero.
+    timestamps.push_back(QString("2016-05-16 12:00:00:00") + QChar(0x0130));
+
+    std::vector<qint64> times(timestamps.size());
+    unsigned invalid = Timestamp::parseBatch(timestamps.data(), timestamps.size(), times.data(), allowSimd);
+
+    unsigned expectedInvalid = 0;
+    for (unsigned i=0; i<timestamps.size(); ++i){
+        qint64 expected = 0;
+        if (Timestamp::parse(timestamps[i], &expected)){
+            QCOMPARE(times[i], expected);
+        } else {
+            QCOMPARE(times[i], Timestamp::INVALID_TIME);
+            ++expectedInvalid;
+        }
+    }
+    QCOMPARE(invalid, expectedInvalid);
+    QVERIFY(invalid >= 6);
+    QCOMPARE(Timestamp::parseBatch(nullptr, 0, nullptr, allowSimd), 0u);
+}
+
+
+void TimestampTest::batchTest_data()
+{
+    QTest::addColumn<bool>("allowSimd");
+    QTest::newRow("scalar") << false;
+    if (Timestamp::simdAvailable()){
+        QTest::newRow("simd") << true;
+    }
+}
+
+
+void TimestampTest::nowTest()
+{
+    QString before = QDateTime::currentDateTime().toString(Event::TIME_FORMAT);
+    QString now = Timestamp::now();
+    QString after = QDateTime::currentDateTime().toString(Event::TIME_FORMAT);
+
+    // Timestamps of the same length sort chronologically.
+    QVERIFY(Timestamp::isValid(now));
+    QVERIFY(before <= now);
+    QVERIFY(now <= after);
+}
+
+
+QTEST_APPLESS_MAIN(TimestampTest)
+
+#include "tst_timestamptest.moc"
@@ -0,0 +1,24 @@
+QT       += testlib
+
+QT       -= gui
+
+TARGET = tst_tracerecordertest
+CONFIG   += console c++11
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+INCLUDEPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+DEPENDPATH += \
+    ../../EventTimer/inc/ \
+    ../../EventTimer/src/
+
+SOURCES += \
+    tst_tracerecordertest.cc \
+    ../../EventTimer/src/tracerecorder.cc
+
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
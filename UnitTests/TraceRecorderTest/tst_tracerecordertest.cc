@@ -0,0 +1,228 @@
+/**
+ * @file
+ * @brief Unit tests for the EventTimerNS::TraceRecorder and EventTimerNS::TraceSpan classes.
+ * @author Perttu Paarlahti 2016.
+ */
+
+#include <QString>
+#include <QtTest>
+#include <QThread>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <memory>
+#include <vector>
+#include "tracerecorder.hh"
+#include "tracespan.hh"
+
+
+namespace
+{
+
+// Records spans from its own thread.
+class SpanThread : public QThread
+{
+public:
+    SpanThread(EventTimerNS::TraceRecorder* recorder, unsigned count) :
+        QThread(), recorder_(recorder), count_(count)
+    {
+    }
+
+protected:
+    void run()
+    {
+        for (unsigned i=0; i<count_; ++i){
+            EventTimerNS::TraceSpan span(recorder_, "thread");
+        }
+    }
+
+private:
+    EventTimerNS::TraceRecorder* recorder_;
+    unsigned count_;
+};
+
+} // Anonymous namespace
+
+
+/**
+ * @brief Unit tests for the EventTimerNS::TraceRecorder class.
+ */
+class TraceRecorderTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    TraceRecorderTest();
+
+private Q_SLOTS:
+
+    /**
+     * @brief Test recording nested spans.
+     */
+    void spanTest();
+
+    /**
+     * @brief Test that spans without recorder are not recorded.
+     */
+    void disabledTest();
+
+    /**
+     * @brief Test that spans are dropped when the recorder is full.
+     */
+    void capacityTest();
+
+    /**
+     * @brief Test clearing the recorder.
+     */
+    void clearTest();
+
+    /**
+     * @brief Test recording spans from several threads.
+     */
+    void concurrentTest();
+
+    /**
+     * @brief Test writing spans as Chrome trace-event JSON.
+     */
+    void chromeTraceTest();
+};
+
+
+TraceRecorderTest::TraceRecorderTest()
+{
+}
+
+
+void TraceRecorderTest::spanTest()
+{
+    using EventTimerNS::TraceSpan;
+    EventTimerNS::TraceRecorder recorder(10);
+    {
+        TraceSpan outer(&recorder, "outer");
+        {
+            TraceSpan inner(&recorder, "inner");
+            QTest::qSleep(2);
+        }
+    }
+
+    // Spans are stored in the order they end.
+    std::vector<EventTimerNS::TraceRecorder::Span> spans = recorder.spans();
+    QCOMPARE(recorder.size(), 2u);
+    QCOMPARE(spans.size(), std::size_t(2));
+    QCOMPARE(QByteArray(spans[0].name), QByteArray("inner"));
+    QCOMPARE(QByteArray(spans[1].name), QByteArray("outer"));
+    QVERIFY(spans[0].durationNsec >= 1000000);
+    QVERIFY(spans[1].startNsec <= spans[0].startNsec);
+    QVERIFY(spans[1].startNsec + spans[1].durationNsec >= spans[0].startNsec + spans[0].durationNsec);
+    QCOMPARE(spans[0].threadId, spans[1].threadId);
+    QVERIFY(recorder.now() >= spans[1].startNsec + spans[1].durationNsec);
+}
+
+
+void TraceRecorderTest::disabledTest()
+{
+    EventTimerNS::TraceRecorder recorder(10);
+    {
+        EventTimerNS::TraceSpan span(nullptr, "disabled");
+    }
+    QCOMPARE(recorder.size(), 0u);
+    QCOMPARE(recorder.dropped(), quint64(0));
+}
+
+
+void TraceRecorderTest::capacityTest()
+{
+    EventTimerNS::TraceRecorder recorder(3);
+    for (int i=0; i<5; ++i){
+        recorder.record("span", recorder.now());
+    }
+    QCOMPARE(recorder.size(), 3u);
+    QCOMPARE(recorder.spans().size(), std::size_t(3));
+    QCOMPARE(recorder.dropped(), quint64(2));
+}
+
+
+void TraceRecorderTest::clearTest()
+{
+    EventTimerNS::TraceRecorder recorder(3);
+    for (int i=0; i<5; ++i){
+        recorder.record("span", recorder.now());
+    }
+    recorder.clear();
+    QCOMPARE(recorder.size(), 0u);
+    QCOMPARE(recorder.dropped(), quint64(0));
+    QVERIFY(recorder.spans().empty());
+
+    recorder.record("span", recorder.now());
+    QCOMPARE(recorder.size(), 1u);
+}
+
+
+void TraceRecorderTest::concurrentTest()
+{
+    const unsigned THREADS = 4;
+    const unsigned SPANS = 10000;
+    EventTimerNS::TraceRecorder recorder(THREADS * SPANS / 2);
+
+    std::vector<std::unique_ptr<SpanThread> > threads;
+    for (unsigned i=0; i<THREADS; ++i){
+        threads.emplace_back(new SpanThread(&recorder, SPANS));
+        threads.back()->start();
+    }
+    for (auto& thread : threads){
+        QVERIFY(thread->wait(30000));
+    }
+
+    // Every span is either stored or counted as dropped.
+    QCOMPARE(recorder.size(), THREADS * SPANS / 2);
+    QCOMPARE(recorder.dropped(), quint64(THREADS * SPANS / 2));
+    for (const EventTimerNS::TraceRecorder::Span& s : recorder.spans()){
+        QCOMPARE(QByteArray(s.name), QByteArray("thread"));
+        QVERIFY(s.durationNsec >= 0);
+    }
+}
+
+
+void TraceRecorderTest::chromeTraceTest()
+{
+    EventTimerNS::TraceRecorder recorder(10);
+    {
+        EventTimerNS::TraceSpan span(&recorder, "main");
+    }
+    SpanThread thread(&recorder, 2);
+    thread.start();
+    QVERIFY(thread.wait(30000));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString fileName = dir.path() + "/trace.json";
+    QString error;
+    QVERIFY(recorder.writeChromeTrace(fileName, &error));
+    QVERIFY(error.isEmpty());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    QCOMPARE(parseError.error, QJsonParseError::NoError);
+
+    QJsonArray events = doc.object().value("traceEvents").toArray();
+    QCOMPARE(events.size(), 3);
+    QJsonObject first = events.at(0).toObject();
+    QCOMPARE(first.value("name").toString(), QString("main"));
+    QCOMPARE(first.value("ph").toString(), QString("X"));
+    QVERIFY(first.value("ts").isDouble());
+    QVERIFY(first.value("dur").toDouble() >= 0);
+    QCOMPARE(first.value("tid").toInt(), 1);
+    QCOMPARE(events.at(1).toObject().value("tid").toInt(), 2);
+    QCOMPARE(events.at(2).toObject().value("tid").toInt(), 2);
+
+    QVERIFY(!recorder.writeChromeTrace(dir.path() + "/missing/trace.json", &error));
+    QVERIFY(!error.isEmpty());
+}
+
+
+QTEST_APPLESS_MAIN(TraceRecorderTest)
+
+#include "tst_tracerecordertest.moc"
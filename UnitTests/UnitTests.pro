@@ -2,6 +2,18 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     EventTest \
+    EventBenchmark \
     DatabaseHandlerTest \
     DatabaseHandlerBenchmark \
-    EventTimerLogicTest
+    EventTimerLogicBenchmark \
+    EventTimerLogicTest \
+    LatencyHistogramTest \
+    AsyncLoggerTest \
+    ScheduleIndexTest \
+    EventCacheTest \
+    NamePoolTest \
+    EventBatchTest \
+    TimestampTest \
+    TraceRecorderTest \
+    ScheduleViewTest \
+    EventTimerCoreTest